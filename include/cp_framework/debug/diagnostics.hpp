@@ -10,6 +10,7 @@
 #include <mutex>
 #include "cp_framework/core/export.hpp"
 #include "cp_framework/core/types.hpp"
+#include "cp_framework/threading/threadPool.hpp"
 #include "debug.hpp"
 
 namespace cp
@@ -260,6 +261,7 @@ namespace cp
      * - FPS tracking via FrameCounter
      * - Named timers with aggregated statistics (TimerSampler)
      * - Per-frame begin/end tracking
+     * - ThreadPool telemetry (see SetThreadPool())
      */
     class DiagnosticsManager
     {
@@ -325,7 +327,15 @@ namespace cp
         }
 
         /**
-         * @brief Returns a formatted summary including FPS and timer statistics.
+         * @brief Sets the thread pool whose counters are included in Summary().
+         *
+         * @param pool Pool to report on, or nullptr to stop reporting. Must
+         *             outlive this manager or be reset before destruction.
+         */
+        void SetThreadPool(const ThreadPool *pool) { m_threadPool = pool; }
+
+        /**
+         * @brief Returns a formatted summary including FPS, timer and thread pool statistics.
          *
          * @return Human-readable diagnostics string.
          */
@@ -348,6 +358,31 @@ namespace cp
                        " (min " + std::to_string(sampler.GetMin()) +
                        ", max " + std::to_string(sampler.GetMax()) + ")\n";
             }
+
+            if (m_threadPool)
+            {
+                const ThreadPoolStats stats = m_threadPool->GetStats();
+                out += "ThreadPool: " + std::to_string(stats.activeWorkers) + "/" + std::to_string(stats.workers.size()) + " workers, " +
+                       std::to_string(static_cast<uint32_t>(stats.Utilization() * 100.0)) + "% busy, " +
+                       std::to_string(stats.total.queueDepth) + " queued" +
+                       " (spawned " + std::to_string(stats.spawned) +
+                       ", retired " + std::to_string(stats.retired) + ")" +
+                       ", dropped " + std::to_string(stats.total.cancelled) + " cancelled" +
+                       " / " + std::to_string(stats.total.expired) + " expired\n";
+                for (size_t i = 0; i < stats.workers.size(); ++i)
+                {
+                    const WorkerStats &w = stats.workers[i];
+                    out += "   *worker " + std::to_string(i) + (w.active ? "" : " (inactive)") + " : " +
+                           std::to_string(w.executed) + " executed" +
+                           " (stolen " + std::to_string(w.stolen) +
+                           ", failed steals " + std::to_string(w.failedSteals) + ")" +
+                           ", dropped " + std::to_string(w.cancelled) + " cancelled" +
+                           " / " + std::to_string(w.expired) + " expired" +
+                           ", busy " + std::to_string(static_cast<double>(w.busyNs) * 1e-6) + " ms" +
+                           ", idle " + std::to_string(static_cast<double>(w.idleNs) * 1e-6) + " ms" +
+                           ", depth " + std::to_string(w.queueDepth) + "\n";
+                }
+            }
             return out;
         }
 
@@ -364,5 +399,6 @@ namespace cp
         FrameCounter m_frameCounter;
         std::unordered_map<string, uint64_t> m_timerStartTimes;
         std::unordered_map<string, TimerSampler> m_timerSamplers;
+        const ThreadPool *m_threadPool = nullptr;
     };
 }
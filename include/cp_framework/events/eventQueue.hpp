@@ -0,0 +1,251 @@
+/**
+ * @file eventQueue.hpp
+ * @brief Lock-free multi-producer, single-consumer queue storing events inline in a byte ring.
+ */
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+#include "cp_framework/core/export.hpp"
+
+namespace cp
+{
+    /**
+     * @class EventQueue
+     * @brief Queue of events of any type, constructed in place in a fixed byte ring.
+     *
+     * Each event is stored as a small record header followed by the event
+     * object itself, so queueing costs no allocation: a producer reserves
+     * space with one CAS on the write cursor, constructs the event in place
+     * and publishes the record with a release store. The single consumer
+     * walks the ring in order, hands every event to its handler and destroys
+     * it where it lies before returning the space to producers.
+     *
+     * Consume() swaps out everything queued so far as one batch and
+     * dispatches it grouped by the type ID given to Emplace(), not by handler,
+     * which may differ between DLLs for the same event type. Within a type events keep their
+     * queue order, and the groups follow the order in which their types first
+     * appear in the batch. A time budget may cut a batch short; the rest of
+     * it is dispatched first by the next call.
+     *
+     * When the ring is full, or an event is too large or over-aligned for it,
+     * the event is heap-allocated into an overflow list instead of blocking
+     * the producer (which may be the consumer itself, queueing from a
+     * listener). While overflowed events are pending every producer uses the
+     * overflow list, and the consumer only takes it once the ring has drained,
+     * so events from one thread are always dispatched in the order queued.
+     */
+    class CP_API EventQueue
+    {
+    public:
+        /**
+         * @brief Dispatches the event at @p payload to @p context (skipped when null), then destroys it in place.
+         */
+        using Handler = void (*)(void *context, void *payload);
+
+        static constexpr size_t kDefaultCapacity = 256 * 1024; ///< Default ring size in bytes
+        static constexpr size_t kRecordAlign = 16;             ///< Alignment of records (and of events stored inline)
+
+        /**
+         * @brief Allocates the ring.
+         *
+         * @param capacity Ring size in bytes, rounded up to a power of two.
+         */
+        explicit EventQueue(size_t capacity = kDefaultCapacity);
+
+        /**
+         * @brief Destroys pending events without dispatching them.
+         *
+         * No producer may be running.
+         */
+        ~EventQueue();
+
+        EventQueue(const EventQueue &) = delete;
+        EventQueue &operator=(const EventQueue &) = delete;
+
+        /**
+         * @brief Constructs an event of type @p T in the queue from @p args. Thread-safe and lock-free.
+         *
+         * @param type Identifies T for grouping; must fit in 30 bits (see EventTypeId()).
+         * @param handler Function that dispatches and destroys a T (see Handler).
+         * @param args Constructor arguments, forwarded, so an rvalue event is moved in.
+         */
+        template <typename T, typename... Args>
+        void Emplace(uint32_t type, Handler handler, Args &&...args)
+        {
+            constexpr size_t size = (sizeof(Record) + sizeof(T) + kRecordAlign - 1) & ~(kRecordAlign - 1);
+
+            if constexpr (alignof(T) <= kRecordAlign)
+            {
+                if (Record *record = Reserve(size, handler))
+                {
+                    try
+                    {
+                        ::new (static_cast<void *>(record + 1)) T(std::forward<Args>(args)...);
+                    }
+                    catch (...)
+                    {
+                        Commit(record, kSkip);
+                        throw;
+                    }
+                    Commit(record, kReady | type << kStateBits);
+                    return;
+                }
+            }
+
+            void *payload = ::operator new(sizeof(T), std::align_val_t(alignof(T)));
+            try
+            {
+                ::new (payload) T(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                ::operator delete(payload, std::align_val_t(alignof(T)));
+                throw;
+            }
+            PushOverflow(Overflow{handler, payload, alignof(T), type});
+        }
+
+        /**
+         * @brief Dispatches the events queued before the call to @p context, grouped by type. Consumer only.
+         *
+         * Events queued while dispatching are left for the next call. At least
+         * one event is dispatched (if any is queued); the budget is checked
+         * between events, never inside one. An exception thrown by a handler
+         * propagates after its event has been destroyed and removed.
+         *
+         * @param context Passed to every handler.
+         * @param budget Time after which the remaining events are left for the next call.
+         * @return Number of events dispatched.
+         */
+        size_t Consume(void *context, std::chrono::nanoseconds budget = std::chrono::nanoseconds::max());
+
+        /**
+         * @brief Returns whether any event is queued or being queued. Consumer only.
+         */
+        bool HasPending() const;
+
+    private:
+        /**
+         * @brief Record states; a record's state word is zero until its producer publishes it.
+         *
+         * A ready record keeps its event's type ID in the bits above kStateBits.
+         */
+        enum : uint32_t
+        {
+            kEmpty = 0,    ///< Reserved, still being written
+            kReady = 1,    ///< Holds a constructed event
+            kSkip = 2,     ///< Padding up to the end of the ring, a dispatched event, or one whose constructor threw
+            kStateBits = 2,
+            kStateMask = (1u << kStateBits) - 1
+        };
+
+        /**
+         * @brief Header in front of every event stored in the ring.
+         */
+        struct alignas(kRecordAlign) Record
+        {
+            uint32_t state;  ///< One of the states above, plus the type ID; accessed through std::atomic_ref
+            uint32_t size;   ///< Bytes from this record to the next
+            Handler handler; ///< Dispatches and destroys the event that follows
+        };
+
+        /**
+         * @brief Event that did not fit in the ring, allocated on the heap.
+         */
+        struct Overflow
+        {
+            Handler handler;  ///< Dispatches and destroys the event
+            void *payload;    ///< The event
+            size_t alignment; ///< Alignment the payload was allocated with
+            uint32_t type;    ///< Type ID passed to Emplace()
+        };
+
+        /**
+         * @brief Event taken out of the queue, waiting in the current batch.
+         */
+        struct Pending
+        {
+            Handler handler;  ///< Dispatches and destroys the event
+            void *payload;    ///< The event
+            Record *record;   ///< Ring record holding it, or nullptr for an overflowed event
+            size_t alignment; ///< Heap alignment of an overflowed event
+            size_t group;     ///< Index of its type in m_groups while the batch is built
+            uint32_t type;    ///< Type ID passed to Emplace()
+        };
+
+        /**
+         * @brief Events of one type in the batch being built.
+         */
+        struct Group
+        {
+            uint32_t type; ///< Type ID of its events
+            size_t offset; ///< Events counted, then first free slot in m_batch
+        };
+
+        /**
+         * @brief Reserves @p size bytes for a record, or returns nullptr if the event must overflow.
+         */
+        Record *Reserve(size_t size, Handler handler);
+
+        /**
+         * @brief Publishes a reserved record to the consumer.
+         */
+        static void Commit(Record *record, uint32_t state)
+        {
+            std::atomic_ref<uint32_t>(record->state).store(state, std::memory_order_release);
+        }
+
+        /**
+         * @brief Appends an event to the overflow list.
+         */
+        void PushOverflow(Overflow &&entry);
+
+        /**
+         * @brief Returns the record at ring position @p position.
+         */
+        Record *RecordAt(uint64_t position) const
+        {
+            return reinterpret_cast<Record *>(m_ring + (position & m_mask));
+        }
+
+        /**
+         * @brief Takes published ring records up to @p end, then the first
+         *        @p overflowEnd overflowed events, into a new batch grouped by type.
+         *
+         * @return Whether the batch is non-empty.
+         */
+        bool SwapOut(uint64_t end, size_t overflowEnd);
+
+        /**
+         * @brief Dispatches one batch entry and frees or marks its storage.
+         */
+        void Dispatch(void *context, const Pending &entry);
+
+        /**
+         * @brief Hands the space of dispatched records at the read position back to producers.
+         */
+        void ReleaseDispatched();
+
+        std::byte *m_ring = nullptr;                   ///< Ring storage, zeroed wherever no record is live
+        size_t m_capacity = 0;                         ///< Ring size in bytes (power of two)
+        size_t m_mask = 0;                             ///< m_capacity - 1
+        alignas(64) std::atomic<uint64_t> m_head{0};   ///< Producer cursor: bytes reserved so far
+        alignas(64) std::atomic<uint64_t> m_tail{0};   ///< Bytes the consumer has handed back
+        alignas(64) uint64_t m_read = 0;               ///< Oldest record not yet handed back; consumer only
+        uint64_t m_scan = 0;                           ///< Next record to swap out; consumer only
+        std::vector<Pending> m_batch;                  ///< Current batch, grouped by type; consumer only
+        size_t m_batchNext = 0;                        ///< First undispatched entry of m_batch
+        std::vector<Pending> m_swapped;                ///< Scratch: events in queue order while grouping
+        std::vector<Group> m_groups;                   ///< Scratch: types of the batch being built
+        std::atomic<bool> m_overflowing{false};        ///< Overflowed events pending; producers bypass the ring
+        std::mutex m_overflowMutex;                    ///< Guards m_overflow
+        std::vector<Overflow> m_overflow;              ///< Events that did not fit in the ring, in queue order
+    };
+} // namespace cp
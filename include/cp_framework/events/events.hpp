@@ -12,14 +12,16 @@
 #include <algorithm>
 #include <mutex>
 #include <atomic>
-#include <queue>
+#include <cassert>
+#include <chrono>
 #include <optional>
 #include <thread>
-#include <condition_variable>
 #include "cp_framework/core/export.hpp"
+#include "cp_framework/events/eventQueue.hpp"
 
 namespace cp
 {
+    class ThreadPool;
 
     /**
      * @brief Base class for all events.
@@ -36,6 +38,59 @@ namespace cp
      */
     using ListenerID = uint64_t;
 
+    /**
+     * @brief How a listener may be run when a queued event is dispatched.
+     */
+    enum class ListenerExecution
+    {
+        Serial,  ///< On the dispatching thread, in subscription order
+        Parallel ///< On any pool worker, concurrently with the other parallel listeners of its priority
+    };
+
+    /**
+     * @brief Dense index of an event type (0, 1, 2, ... in order of first use).
+     */
+    using EventTypeID = uint32_t;
+
+    /**
+     * @brief Returns the dense ID registered for @p type, assigning the next free one on first sight.
+     *
+     * The registry lives in the framework library and is looked up by
+     * std::type_info, which compares equal across modules, so a type gets the
+     * same ID in every DLL and executable. Prefer EventTypeId<T>(), which
+     * caches the result.
+     */
+    CP_API EventTypeID RegisterEventType(const std::type_info &type);
+
+    /**
+     * @brief Returns the dense ID of @p EventType.
+     *
+     * The registry is consulted once per type and module; afterwards the ID
+     * is a function-local static, so lookups cost no hashing.
+     */
+    template <typename EventType>
+    EventTypeID EventTypeId()
+    {
+        static const EventTypeID id = RegisterEventType(typeid(EventType));
+        return id;
+    }
+
+    /**
+     * @brief Event type built by QueueEvent(): the explicit template argument,
+     *        or the decayed type of a single deduced argument.
+     */
+    template <typename EventType, typename... Args>
+    struct QueuedEventType
+    {
+        using type = EventType;
+    };
+
+    template <typename Arg>
+    struct QueuedEventType<void, Arg>
+    {
+        using type = std::decay_t<Arg>;
+    };
+
     /**
      * @brief Manages registration, dispatching, and asynchronous queuing of events.
      *
@@ -43,15 +98,40 @@ namespace cp
      * - Listener registration with priority
      * - Listener removal
      * - Immediate (synchronous) event dispatch
-     * - Asynchronous event queuing with thread processing
+     * - Asynchronous event queuing, dispatched either once per frame with
+     *   DispatchQueued() or continuously by an optional thread (StartAsync())
+     *
+     * Listener lists are copy-on-write: each event type owns an immutable,
+     * priority-sorted snapshot that Subscribe() and Unsubscribe() replace
+     * under a writer mutex, while Emit() only loads the current snapshot
+     * atomically and walks it without any lock. Emitting unrelated (or the
+     * same) events from several threads therefore never serializes, and a
+     * listener may subscribe, unsubscribe or emit from inside its callback.
+     * Changes take effect for the next Emit(): an emit already in progress
+     * finishes on the snapshot it started with, so a listener removed
+     * concurrently can still receive that one event. Each type counts its
+     * emits in flight in two alternating generations; a replaced snapshot is
+     * freed once the generations that could have loaded it have drained, so
+     * reclamation never waits for emits to stop altogether and emitters of
+     * different types never touch the same counter.
+     *
+     * Listeners subscribed as ListenerExecution::Parallel must not depend on
+     * each other or on the dispatching thread. When a queued event is
+     * dispatched and a pool was attached with SetThreadPool(), each priority
+     * tier first runs its serial listeners on the dispatching thread, then
+     * fans its parallel listeners out across the pool and joins them before
+     * the next tier starts, so priorities still order the tiers. Emit() and
+     * dispatchers without a pool run every listener serially.
      */
-    class EventDispatcher
+    class CP_API EventDispatcher
     {
     public:
         /**
          * @brief Constructs the dispatcher and initializes the listener ID counter.
+         *
+         * @param queueCapacity Bytes of inline storage for queued events (see EventQueue).
          */
-        EventDispatcher();
+        explicit EventDispatcher(size_t queueCapacity = EventQueue::kDefaultCapacity);
 
         /**
          * @brief Destructor. Ensures that the async processing thread is stopped safely.
@@ -64,32 +144,21 @@ namespace cp
          * @tparam EventType The event type to subscribe to.
          * @param callback Function to be called when the event is emitted.
          * @param priority Higher priority listeners are called earlier.
+         * @param execution Whether queued events may run the listener on pool workers,
+         *                  after the serial listeners of the same priority.
          * @return ListenerID A unique ID that can be used to unsubscribe.
          */
         template <typename EventType>
-        ListenerID Subscribe(std::function<void(const EventType &)> callback, int priority = 0)
+        ListenerID Subscribe(std::function<void(const EventType &)> callback, int priority = 0,
+                             ListenerExecution execution = ListenerExecution::Serial)
         {
-            const std::type_index type = typeid(EventType);
-            std::unique_lock lock(m_mutex);
-
             ListenerID id = m_nextListenerID++;
-            auto wrapper = [callback](const Event &e)
+            auto wrapper = [callback = std::move(callback)](const Event &e)
             {
                 callback(static_cast<const EventType &>(e));
             };
 
-            ListenerEntry entry{id, priority, wrapper};
-
-            auto &vec = m_listeners[type];
-            vec.push_back(entry);
-
-            // Sort by priority (descending)
-            std::sort(vec.begin(), vec.end(),
-                      [](const ListenerEntry &a, const ListenerEntry &b)
-                      {
-                          return a.priority > b.priority;
-                      });
-
+            AddListener(EventTypeId<EventType>(), ListenerEntry{id, priority, execution, std::move(wrapper)});
             return id;
         }
 
@@ -102,18 +171,7 @@ namespace cp
         template <typename EventType>
         void Unsubscribe(ListenerID id)
         {
-            const std::type_index type = typeid(EventType);
-            std::unique_lock lock(m_mutex);
-
-            auto it = m_listeners.find(type);
-            if (it == m_listeners.end())
-                return;
-
-            auto &vec = it->second;
-            vec.erase(std::remove_if(vec.begin(), vec.end(),
-                                     [id](const ListenerEntry &e)
-                                     { return e.id == id; }),
-                      vec.end());
+            RemoveListener(EventTypeId<EventType>(), id);
         }
 
         /**
@@ -125,14 +183,17 @@ namespace cp
         template <typename EventType>
         void Emit(const EventType &event)
         {
-            const std::type_index type = typeid(EventType);
-            std::unique_lock lock(m_mutex);
+            ListenerSlot *slot = FindSlot(EventTypeId<EventType>());
+            if (!slot)
+                return;
 
-            auto it = m_listeners.find(type);
-            if (it == m_listeners.end())
+            // Snapshots replaced while the scope is open stay alive until it closes.
+            EmitScope scope(*slot);
+            const ListenerList *listeners = scope.Listeners();
+            if (!listeners)
                 return;
 
-            for (auto &entry : it->second)
+            for (const ListenerEntry &entry : *listeners)
                 entry.callback(event);
         }
 
@@ -143,19 +204,64 @@ namespace cp
         /**
          * @brief Queues an event for asynchronous processing.
          *
-         * @tparam EventType The event type.
-         * @param event The event instance to enqueue.
+         * It is dispatched by the next DispatchQueued() call, or by the async
+         * thread if one was started. The event is constructed in place in the queue's ring buffer, moved
+         * or copied from @p args, and destroyed in place once dispatched; no
+         * lock is taken and, unless the ring is full, nothing is allocated:
+         * @code
+         * dispatcher.QueueEvent(event);                   // copies event
+         * dispatcher.QueueEvent(std::move(event));        // moves event
+         * dispatcher.QueueEvent<onResize>(width, height); // constructs an onResize in place
+         * @endcode
+         *
+         * @tparam EventType The event type; deduced from a single argument if omitted.
+         * @param args The event instance, or constructor arguments for an EventType.
          */
-        template <typename EventType>
-        void QueueEvent(const EventType &event)
+        template <typename EventType = void, typename... Args>
+        void QueueEvent(Args &&...args)
         {
-            std::unique_lock lock(m_queueMutex);
-            m_eventQueue.push(std::make_shared<EventWrapperTyped<EventType>>(event));
-            m_cv.notify_one();
+            using T = typename QueuedEventType<EventType, Args...>::type;
+            static_assert(std::is_base_of_v<Event, T>, "Queued events must derive from cp::Event");
+
+            m_queue.Emplace<T>(EventTypeId<T>(), &HandleQueued<T>, std::forward<Args>(args)...);
+
+            // Pairs with the fence in ProcessQueue(): either it sees the event or we see it parked.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_parked.load(std::memory_order_relaxed) && m_parked.exchange(false, std::memory_order_acq_rel))
+                m_parked.notify_one();
         }
 
         /**
-         * @brief Starts the asynchronous event processing thread.
+         * @brief Dispatches the events queued so far, grouped by type, within a time budget.
+         *
+         * The queue is swapped out as a whole and its events are emitted one
+         * type after another (in queue order within a type), which keeps each
+         * type's listeners hot in cache. Events queued while dispatching,
+         * including by listeners, wait for the next call; so does whatever the
+         * budget cut off, ahead of anything newer. Framework::Run calls this
+         * once per frame on the EventSystem.
+         *
+         * Must not be called while the async thread is running, nor
+         * concurrently with itself.
+         *
+         * @param budget Time after which the remaining events are left for the next call.
+         * @return Number of events dispatched.
+         */
+        size_t DispatchQueued(std::chrono::nanoseconds budget = std::chrono::nanoseconds::max());
+
+        /**
+         * @brief Sets the pool that parallel listeners of queued events run on.
+         *
+         * @param pool Pool to fan out to, or nullptr to run every listener
+         *             serially. Must outlive its use or be reset first.
+         */
+        void SetThreadPool(ThreadPool *pool) { m_threadPool.store(pool, std::memory_order_release); }
+
+        /**
+         * @brief Starts a thread that dispatches queued events as they arrive.
+         *
+         * Optional: without it, queued events wait for DispatchQueued().
+         * Does nothing if the thread is already running.
          */
         void StartAsync();
 
@@ -174,51 +280,142 @@ namespace cp
         {
             ListenerID id;                               ///< Unique listener ID
             int priority;                                ///< Listener priority
+            ListenerExecution execution;                 ///< Serial or parallel dispatch of queued events
             std::function<void(const Event &)> callback; ///< Callback function
         };
 
-        std::unordered_map<std::type_index, std::vector<ListenerEntry>> m_listeners; ///< Listeners indexed by event type
-        std::mutex m_mutex;                                                          ///< Mutex for listener map
-        std::atomic<ListenerID> m_nextListenerID;                                    ///< Generates unique listener IDs
+        /// @brief Listeners of one event type, sorted by descending priority, serial before parallel. Immutable once published.
+        using ListenerList = std::vector<ListenerEntry>;
 
         /**
-         * @brief Abstract wrapper for queued events.
+         * @brief Listeners of one event type, republished as a whole on every change.
          *
-         * Enables storing events of different types in the same queue.
+         * Emits join the reader count of the current epoch. A replaced snapshot
+         * first waits in @c pending; once the other epoch's count is zero the
+         * epoch flips, so no new emit can load it, and it moves to @c draining
+         * until the count of the epoch it was retired in drains too.
+         */
+        struct alignas(64) ListenerSlot
+        {
+            std::atomic<const ListenerList *> listeners{nullptr};         ///< Current snapshot, read by Emit()
+            std::atomic<uint32_t> epoch{0};                               ///< Reader count new emits join (0 or 1)
+            std::atomic<uint32_t> readers[2]{};                           ///< Emits in flight per epoch
+            std::atomic<bool> hasRetired{false};                          ///< Whether pending or draining is non-empty
+            std::atomic<bool> reclaimRequested{false};                    ///< Reclamation asked for while reclaimMutex was held
+            std::unique_ptr<const ListenerList> owner;                    ///< Owns the current snapshot (writers only)
+            std::mutex reclaimMutex;                                      ///< Guards pending, draining and epoch flips
+            std::vector<std::unique_ptr<const ListenerList>> pending;     ///< Retired since the last flip; any emit may hold them
+            std::vector<std::unique_ptr<const ListenerList>> draining;    ///< Retired before the last flip; only the old epoch may hold them
+        };
+
+        /// @brief Slots indexed by EventTypeID (nullptr = no listener ever). Immutable once published; replaced when it must grow.
+        using SlotTable = std::vector<ListenerSlot *>;
+
+        /**
+         * @brief Marks an emit in flight on one slot; the last one out of an epoch reclaims what it pinned.
          */
-        struct EventWrapper
+        struct EmitScope
         {
-            virtual ~EventWrapper() = default;
+            ListenerSlot &slot; ///< Slot being emitted on
+            uint32_t epoch;     ///< Reader count this emit joined
+
+            explicit EmitScope(ListenerSlot &s) : slot(s)
+            {
+                while (true)
+                {
+                    epoch = slot.epoch.load(std::memory_order_seq_cst);
+                    slot.readers[epoch].fetch_add(1, std::memory_order_seq_cst);
+                    // A flip in between means a reclaimer may not have counted us; join the new epoch instead.
+                    if (slot.epoch.load(std::memory_order_seq_cst) == epoch)
+                        return;
+                    Leave();
+                }
+            }
+
+            ~EmitScope() { Leave(); }
 
             /**
-             * @brief Dispatches the stored event through the EventDispatcher.
+             * @brief Loads the current snapshot; valid until the scope closes.
              */
-            virtual void Dispatch(EventDispatcher *dispatcher) = 0;
+            const ListenerList *Listeners() const
+            {
+                // Pairs with the seq_cst store in Publish() and the epoch flip (see ReclaimRetiredLocked()).
+                return slot.listeners.load(std::memory_order_seq_cst);
+            }
+
+            void Leave()
+            {
+                if (slot.readers[epoch].fetch_sub(1, std::memory_order_seq_cst) == 1 &&
+                    slot.hasRetired.load(std::memory_order_seq_cst))
+                    ReclaimRetired(slot);
+            }
         };
 
+        std::atomic<const SlotTable *> m_slots{nullptr};            ///< Current slot table (lock-free reads)
+        std::vector<std::unique_ptr<const SlotTable>> m_slotTables; ///< Every table ever published; grows geometrically, so few
+        std::vector<std::unique_ptr<ListenerSlot>> m_slotStorage;   ///< Every slot; slots live as long as the dispatcher
+        std::mutex m_mutex;                                         ///< Serializes listener changes (Emit() never locks)
+        std::atomic<ListenerID> m_nextListenerID;                   ///< Generates unique listener IDs
+
+        /**
+         * @brief Publishes a copy of the type's listener list with @p entry inserted after its equal-priority peers.
+         */
+        void AddListener(EventTypeID type, ListenerEntry &&entry);
+
+        /**
+         * @brief Publishes a copy of the type's listener list without listener @p id.
+         */
+        void RemoveListener(EventTypeID type, ListenerID id);
+
+        /**
+         * @brief Returns the listener slot of @p type, or nullptr if nobody ever subscribed. Lock-free.
+         */
+        ListenerSlot *FindSlot(EventTypeID type) const;
+
+        /**
+         * @brief Replaces the slot's snapshot and retires the old one. Requires m_mutex.
+         */
+        void Publish(ListenerSlot &slot, std::unique_ptr<const ListenerList> next);
+
         /**
-         * @brief Templated wrapper that holds a specific event type.
+         * @brief Frees the slot's retired snapshots that no emit can still hold, flipping its epoch when possible.
          *
-         * @tparam T The event type.
+         * Never blocks: if another thread is reclaiming, it repeats the work on our behalf.
+         */
+        static void ReclaimRetired(ListenerSlot &slot);
+
+        /**
+         * @brief Body of ReclaimRetired(). Requires the slot's reclaimMutex.
+         */
+        static void ReclaimRetiredLocked(ListenerSlot &slot);
+
+        /**
+         * @brief EventQueue::Handler for events of type @p T: emits the event, then destroys it in place.
          */
         template <typename T>
-        struct EventWrapperTyped : EventWrapper
+        static void HandleQueued(void *dispatcher, void *payload)
         {
-            T event; ///< Stored event instance
+            T &event = *static_cast<T *>(payload);
+            struct Destroy
+            {
+                T &event;
+                ~Destroy() { event.~T(); }
+            } destroy{event};
 
-            EventWrapperTyped(const T &e) : event(e) {}
+            if (dispatcher)
+                static_cast<EventDispatcher *>(dispatcher)->EmitQueued(EventTypeId<T>(), event);
+        }
 
-            void Dispatch(EventDispatcher *dispatcher) override
-            {
-                dispatcher->Emit(event);
-            }
-        };
+        /**
+         * @brief Emits a dequeued event tier by tier, fanning parallel listeners out to the pool.
+         */
+        void EmitQueued(EventTypeID type, const Event &event);
 
-        std::queue<std::shared_ptr<EventWrapper>> m_eventQueue; ///< Queue of pending events
-        std::mutex m_queueMutex;                                ///< Mutex protecting the event queue
-        std::condition_variable m_cv;                           ///< Condition variable for queue notifications
-        std::thread m_thread;                                   ///< Thread processing asynchronous events
-        std::atomic<bool> m_running{false};                     ///< Indicates whether the thread is running
+        EventQueue m_queue;                              ///< Queued events, stored inline
+        std::atomic<ThreadPool *> m_threadPool{nullptr}; ///< Runs parallel listeners of queued events
+        std::atomic<bool> m_parked{false};               ///< Async thread asleep; the first producer to clear it wakes the thread
+        std::thread m_thread;                            ///< Thread processing asynchronous events
+        std::atomic<bool> m_running{false};              ///< Indicates whether the thread is running
 
         /**
          * @brief Internal loop executed by the asynchronous processing thread.
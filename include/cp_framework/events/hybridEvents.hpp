@@ -44,10 +44,12 @@ namespace cp
          * @tparam EventType The type of event to listen for.
          * @param del The delegate to invoke when the event is emitted.
          * @param priority Listener priority (higher = executed earlier).
+         * @param execution Whether queued events may run the listener on pool workers.
          * @return ListenerID A unique ID representing the registered listener.
          */
         template <typename EventType>
-        CP_API_EXPORT ListenerID Subscribe(const Delegate<void(const EventType &)> &del, int priority = 0)
+        CP_API_EXPORT ListenerID Subscribe(const Delegate<void(const EventType &)> &del, int priority = 0,
+                                           ListenerExecution execution = ListenerExecution::Serial)
         {
             // Capture delegate in local variable
             Delegate<void(const EventType &)> localDel = del;
@@ -57,7 +59,7 @@ namespace cp
                 {
                     localDel.Invoke(e);
                 },
-                priority);
+                priority, execution);
         }
 
         // ---------------------------
@@ -72,13 +74,15 @@ namespace cp
          * @tparam F The type of the callable.
          * @param callback The callable that will be invoked on event emission.
          * @param priority Listener priority.
+         * @param execution Whether queued events may run the listener on pool workers.
          * @return ListenerID A unique ID representing the registered listener.
          */
         template <typename EventType, typename F>
-        CP_API_EXPORT ListenerID Subscribe(F &&callback, int priority = 0)
+        CP_API_EXPORT ListenerID Subscribe(F &&callback, int priority = 0,
+                                           ListenerExecution execution = ListenerExecution::Serial)
         {
             return this->EventDispatcher::template Subscribe<EventType>(
-                std::forward<F>(callback), priority);
+                std::forward<F>(callback), priority, execution);
         }
 
         // ---------------------------
@@ -118,15 +122,26 @@ namespace cp
         // ---------------------------
 
         /**
-         * @brief Queues an event for asynchronous processing.
+         * @brief Queues an event for asynchronous processing, constructing it in place.
          *
-         * @tparam EventType The type of event.
-         * @param e The event instance.
+         * @tparam EventType The type of event; deduced from a single argument if omitted.
+         * @param args The event instance, or constructor arguments for an EventType.
          */
-        template <typename EventType>
-        CP_API_EXPORT void QueueEvent(const EventType &e)
+        template <typename EventType = void, typename... Args>
+        CP_API_EXPORT void QueueEvent(Args &&...args)
+        {
+            this->EventDispatcher::template QueueEvent<EventType>(std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Dispatches the queued events within a time budget (see EventDispatcher::DispatchQueued()).
+         *
+         * @param budget Time after which the remaining events are left for the next call.
+         * @return Number of events dispatched.
+         */
+        size_t DispatchQueued(std::chrono::nanoseconds budget = std::chrono::nanoseconds::max())
         {
-            this->EventDispatcher::QueueEvent<EventType>(e);
+            return EventDispatcher::DispatchQueued(budget);
         }
 
         // ---------------------------
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include "cp_framework/core/export.hpp"
 #include "cp_framework/core/types.hpp"
+#include "cp_framework/threading/coroutine.hpp"
 
 /**
  * @defgroup Filesystem Filesystem Utilities
@@ -160,6 +161,47 @@ namespace cp::filesystem
      */
     std::pair<std::shared_ptr<uint8_t[]>, std::span<const uint8_t>> ReadBytesAuto(const file_path &path);
 
+    /**
+     * @brief Owned file contents returned by ReadBytesAsync().
+     *
+     * @ingroup Filesystem
+     */
+    struct FileBytes
+    {
+        std::shared_ptr<uint8_t[]> data; ///< File contents.
+        size_t size = 0;                 ///< Number of bytes in @ref data.
+
+        /** @brief Returns a non-owning view over the contents. */
+        std::span<const uint8_t> view() const noexcept { return {data.get(), size}; }
+    };
+
+    /**
+     * @brief Reads the entire file on a pool worker, for use from coroutines.
+     *
+     * This offloads a blocking read; it is not asynchronous I/O. The
+     * awaiting coroutine is suspended while a worker performs ReadBytes(),
+     * and that worker is blocked in the OS for the whole read, exactly as
+     * the caller would have been. It continues on that worker once the
+     * bytes are in memory, so the next pipeline stage (decompression,
+     * parsing...) runs there as well:
+     * @code
+     * FileBytes file = co_await filesystem::ReadBytesAsync(pool, "textures/albedo.ktx");
+     * @endcode
+     * Errors are reported by rethrowing ReadBytes()' exception at the co_await.
+     *
+     * Each read in flight occupies a worker, so the default LOW lane keeps
+     * reads behind frame work; avoid issuing more concurrent reads than
+     * the pool can spare workers for.
+     *
+     * @param pool Pool that performs the read.
+     * @param path Path to the file (copied into the coroutine frame).
+     * @param priority Lane used for the read; defaults to LOW since the read blocks its worker.
+     * @return Task producing the file contents.
+     *
+     * @ingroup Filesystem
+     */
+    Task<FileBytes> ReadBytesAsync(ThreadPool &pool, file_path path, TaskPriority priority = TaskPriority::LOW);
+
     /**
      * @brief Writes binary data to a file.
      *
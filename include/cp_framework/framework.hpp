@@ -11,6 +11,8 @@ namespace cp
     //-------------------------
     class Window;
     class ThreadPool;
+    class JobFence;
+    class MainThreadQueue;
     class DiagnosticsManager;
     class InputManager;
     class VkManager;
@@ -36,6 +38,28 @@ namespace cp
          */
         void Run();
 
+        /**
+         * @brief Returns the framework's worker pool. Valid after Init().
+         */
+        ThreadPool &GetThreadPool();
+
+        /**
+         * @brief Returns the per-frame job fence. Valid after Init().
+         *
+         * Jobs dispatched through it during update() or fixedUpdate() are
+         * guaranteed to have finished before lateUpdate() runs; the main
+         * thread executes pool tasks while it waits.
+         */
+        JobFence &GetFrameJobs();
+
+        /**
+         * @brief Returns the queue of work handed back to the main thread. Valid after Init().
+         *
+         * Drained once per frame, before update(), within a fixed time
+         * budget; whatever does not fit runs in the next frame.
+         */
+        MainThreadQueue &GetMainThreadQueue();
+
     private:
         void update(const f64 &deltaTime);
         void fixedUpdate(const f64 &fixedTime);
@@ -46,7 +70,10 @@ namespace cp
         std::atomic<bool> m_isRunning{false};
 
         UPTR<Window> m_window;
+        // Declared before the pool so it outlives every worker that may post to it.
+        UPTR<MainThreadQueue> m_mainThreadQueue;
         UPTR<ThreadPool> m_threadPool;
+        UPTR<JobFence> m_frameJobs;
         UPTR<DiagnosticsManager> m_diag;
         UPTR<InputManager> m_input;
         UPTR<VkManager> m_vkManager;
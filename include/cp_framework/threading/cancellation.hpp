@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace cp
+{
+    /**
+     * @class CancellationToken
+     * @brief Read side of a cancellation flag shared with a CancellationSource.
+     *
+     * Tokens are cheap to copy (one shared pointer) and thread-safe. A
+     * default-constructed token is never cancelled, so APIs can take one as
+     * an optional parameter:
+     * @code
+     * CancellationSource source;
+     * pool.SubmitEvery(std::chrono::seconds(5), [] { Autosave(); }, source.Token());
+     * ...
+     * source.Cancel(); // no further runs
+     * @endcode
+     *
+     * Cancellation is cooperative: the pool checks the token before running a
+     * task, and long-running tasks may poll IsCancelled() themselves.
+     *
+     * @ingroup Threading
+     */
+    class CancellationToken
+    {
+    public:
+        CancellationToken() = default;
+
+        /**
+         * @brief Returns whether cancellation was requested.
+         */
+        bool IsCancelled() const noexcept
+        {
+            return m_state && m_state->load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Returns whether the token is connected to a source.
+         */
+        bool CanBeCancelled() const noexcept { return m_state != nullptr; }
+
+    private:
+        friend class CancellationSource;
+
+        explicit CancellationToken(std::shared_ptr<std::atomic<bool>> state) : m_state(std::move(state)) {}
+
+        std::shared_ptr<std::atomic<bool>> m_state; ///< Flag shared with the source, or null.
+    };
+
+    /**
+     * @class CancellationSource
+     * @brief Write side of a cancellation flag; hands out CancellationTokens.
+     *
+     * Cancelling is sticky and idempotent. Copies of a source share the flag.
+     *
+     * @ingroup Threading
+     */
+    class CancellationSource
+    {
+    public:
+        CancellationSource() : m_state(std::make_shared<std::atomic<bool>>(false)) {}
+
+        /**
+         * @brief Returns a token observing this source.
+         */
+        CancellationToken Token() const { return CancellationToken(m_state); }
+
+        /**
+         * @brief Requests cancellation of every task holding one of this source's tokens.
+         */
+        void Cancel() noexcept { m_state->store(true, std::memory_order_release); }
+
+        /**
+         * @brief Returns whether Cancel() was called.
+         */
+        bool IsCancelled() const noexcept { return m_state->load(std::memory_order_acquire); }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> m_state; ///< Shared cancellation flag.
+    };
+} // namespace cp
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "cp_framework/threading/threadPool.hpp"
+
+namespace cp
+{
+    template <typename T = void>
+    class Task;
+
+    /**
+     * @brief State shared by every Task promise: continuation, completion flag and error.
+     *
+     * @ingroup Threading
+     */
+    class TaskPromiseBase
+    {
+    public:
+        /**
+         * @brief Final-suspend awaiter: hands control straight to the awaiting coroutine.
+         *
+         * Symmetric transfer keeps the stack flat for arbitrarily long chains
+         * of `co_await`ed tasks.
+         */
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept
+            {
+                TaskPromiseBase &promise = handle.promise();
+                std::coroutine_handle<> continuation = promise.m_continuation;
+                // Last access to the frame: a SyncWait() caller may destroy it right after.
+                promise.m_done.store(true, std::memory_order_release);
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        /// @brief Tasks are lazy: nothing runs until the task is awaited or started.
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+
+        void unhandled_exception() noexcept { m_error = std::current_exception(); }
+
+        /**
+         * @brief Returns whether the coroutine ran to completion.
+         */
+        bool IsDone() const noexcept { return m_done.load(std::memory_order_acquire); }
+
+    protected:
+        template <typename>
+        friend class Task;
+
+        /**
+         * @brief Rethrows the exception that escaped the coroutine body, if any.
+         */
+        void RethrowIfFailed() const
+        {
+            if (m_error)
+                std::rethrow_exception(m_error);
+        }
+
+        std::coroutine_handle<> m_continuation; ///< Coroutine awaiting this task, if any.
+        std::atomic<bool> m_done{false};        ///< Set once the body finished.
+        std::exception_ptr m_error;             ///< Exception that escaped the body.
+    };
+
+    /**
+     * @brief Promise of a Task producing a value.
+     */
+    template <typename T>
+    class TaskPromise : public TaskPromiseBase
+    {
+    public:
+        Task<T> get_return_object() noexcept;
+
+        template <typename U>
+        void return_value(U &&value) { m_value.emplace(std::forward<U>(value)); }
+
+        /**
+         * @brief Returns the result or rethrows the body's exception.
+         */
+        T Result()
+        {
+            RethrowIfFailed();
+            return std::move(*m_value);
+        }
+
+    private:
+        std::optional<T> m_value; ///< Value passed to co_return.
+    };
+
+    /**
+     * @brief Promise of a Task producing nothing.
+     */
+    template <>
+    class TaskPromise<void> : public TaskPromiseBase
+    {
+    public:
+        Task<void> get_return_object() noexcept;
+
+        void return_void() const noexcept {}
+
+        /**
+         * @brief Rethrows the body's exception, if any.
+         */
+        void Result() const { RethrowIfFailed(); }
+    };
+
+    /**
+     * @class Task
+     * @brief Lazily started coroutine producing a T.
+     *
+     * A Task does nothing until it is awaited (or started by SyncWait()).
+     * Awaiting a Task starts it on the awaiting thread through symmetric
+     * transfer and resumes the awaiter, on whatever thread the task finished,
+     * once it completes. Combined with ThreadPool::Schedule() and the I/O
+     * awaiters this turns multi-stage pipelines into straight-line code
+     * where no worker ever blocks between stages:
+     * @code
+     * Task<Texture> LoadTexture(ThreadPool &pool, file_path path)
+     * {
+     *     filesystem::FileBytes file = co_await filesystem::ReadBytesAsync(pool, path);
+     *     co_await pool.Schedule();                   // continue on a worker
+     *     Image image = Decompress(file);
+     *     co_await ring.WhenUploaded(Upload(image), offset, size, &pool);
+     *     co_return MakeTexture(image);
+     * }
+     *
+     * Texture texture = SyncWait(pool, LoadTexture(pool, "albedo.ktx"));
+     * @endcode
+     *
+     * Exceptions escaping the body are rethrown to the awaiter.
+     *
+     * @note A Task owns its coroutine frame. It must outlive the coroutine's
+     *       execution, which awaiting and SyncWait() guarantee.
+     *
+     * @ingroup Threading
+     */
+    template <typename T>
+    class [[nodiscard]] Task
+    {
+    public:
+        using promise_type = TaskPromise<T>;
+        using Handle = std::coroutine_handle<promise_type>;
+
+        /**
+         * @brief Awaiter returned by `co_await task`.
+         */
+        struct Awaiter
+        {
+            Handle handle; ///< Awaited coroutine.
+
+            /**
+             * @brief Skips the suspension if the task already finished.
+             *
+             * @throws std::invalid_argument if the task is empty (default-constructed or moved from).
+             */
+            bool await_ready() const
+            {
+                if (!handle)
+                    throw std::invalid_argument("co_await: empty task");
+                return handle.promise().IsDone();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) const noexcept
+            {
+                handle.promise().m_continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume() const { return handle.promise().Result(); }
+        };
+
+        Task() = default;
+
+        explicit Task(Handle handle) noexcept : m_handle(handle) {}
+
+        Task(Task &&other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+
+        Task &operator=(Task &&other) noexcept
+        {
+            if (this != &other)
+            {
+                Destroy();
+                m_handle = std::exchange(other.m_handle, {});
+            }
+            return *this;
+        }
+
+        Task(const Task &) = delete;
+        Task &operator=(const Task &) = delete;
+
+        ~Task() { Destroy(); }
+
+        /**
+         * @brief Starts the task (if not started yet) and suspends the caller until it completes.
+         */
+        Awaiter operator co_await() const noexcept { return Awaiter{m_handle}; }
+
+        /**
+         * @brief Runs the task on the calling thread up to its first suspension point.
+         *
+         * Used by SyncWait(); must be called at most once and never on an awaited task.
+         */
+        void Start() const { m_handle.resume(); }
+
+        /**
+         * @brief Returns whether the task finished (an empty task counts as finished).
+         */
+        bool IsDone() const noexcept { return !m_handle || m_handle.promise().IsDone(); }
+
+        /**
+         * @brief Returns the result of a finished task, rethrowing its exception if it failed.
+         */
+        T Get() const { return m_handle.promise().Result(); }
+
+        /**
+         * @brief Returns whether the task refers to a coroutine.
+         */
+        bool Valid() const noexcept { return static_cast<bool>(m_handle); }
+
+    private:
+        void Destroy() noexcept
+        {
+            if (m_handle)
+                m_handle.destroy();
+            m_handle = {};
+        }
+
+        Handle m_handle; ///< Owned coroutine frame.
+    };
+
+    template <typename T>
+    Task<T> TaskPromise<T>::get_return_object() noexcept
+    {
+        return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+    }
+
+    inline Task<void> TaskPromise<void>::get_return_object() noexcept
+    {
+        return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+    }
+
+    /**
+     * @brief Runs a task to completion from synchronous code and returns its result.
+     *
+     * The task starts on the calling thread; while it is suspended the caller
+     * executes pending pool tasks (see ThreadPool::WaitUntil()), so SyncWait()
+     * is safe to call from a worker as well.
+     *
+     * @param pool Pool whose tasks the caller helps with while waiting.
+     * @param task Task to run.
+     * @return The task's result.
+     */
+    template <typename T>
+    T SyncWait(ThreadPool &pool, Task<T> task)
+    {
+        if (!task.Valid())
+            throw std::invalid_argument("SyncWait: empty task");
+
+        task.Start();
+        pool.WaitUntil([&task]
+                       { return task.IsDone(); });
+        return task.Get();
+    }
+} // namespace cp
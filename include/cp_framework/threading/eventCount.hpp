@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace cp
+{
+    /**
+     * @class EventCount
+     * @brief Lock-free "eventcount" for parking idle threads without lost wakeups.
+     *
+     * A waiter announces itself, re-checks its condition, and only then
+     * sleeps on the epoch it observed when announcing:
+     * @code
+     * auto key = ec.PrepareWait();
+     * if (ConditionHolds()) { ec.CancelWait(); return; }
+     * ec.Wait(key);
+     * @endcode
+     * A notifier publishes its state change first and then calls Notify*.
+     * Notification is a single fence plus a load while nobody is waiting,
+     * so producers pay nothing on the fast path. Parking relies on
+     * std::atomic::wait (a futex on Linux).
+     *
+     * @ingroup Threading
+     */
+    class EventCount
+    {
+    public:
+        /// @brief Epoch observed by PrepareWait().
+        using Key = uint32_t;
+
+        /**
+         * @brief Registers the caller as a waiter and returns the current epoch.
+         *
+         * Must be followed by exactly one CancelWait() or Wait().
+         */
+        Key PrepareWait()
+        {
+            m_waiters.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return m_epoch.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Withdraws a PrepareWait() after the condition turned out to hold.
+         */
+        void CancelWait() { m_waiters.fetch_sub(1, std::memory_order_seq_cst); }
+
+        /**
+         * @brief Sleeps until the epoch moves past @p key.
+         */
+        void Wait(Key key)
+        {
+            m_epoch.wait(key, std::memory_order_acquire);
+            m_waiters.fetch_sub(1, std::memory_order_seq_cst);
+        }
+
+        /**
+         * @brief Wakes one waiter, if any.
+         */
+        void NotifyOne()
+        {
+            if (!HasWaiters())
+                return;
+            m_epoch.fetch_add(1, std::memory_order_release);
+            m_epoch.notify_one();
+        }
+
+        /**
+         * @brief Wakes up to @p count waiters.
+         */
+        void NotifyMany(size_t count)
+        {
+            if (count == 0 || !HasWaiters())
+                return;
+            m_epoch.fetch_add(1, std::memory_order_release);
+            for (size_t i = 0; i < count; ++i)
+                m_epoch.notify_one();
+        }
+
+        /**
+         * @brief Wakes every waiter.
+         */
+        void NotifyAll()
+        {
+            if (!HasWaiters())
+                return;
+            m_epoch.fetch_add(1, std::memory_order_release);
+            m_epoch.notify_all();
+        }
+
+        /**
+         * @brief Returns the number of registered waiters (approximate, for heuristics).
+         */
+        uint32_t WaiterCount() const { return m_waiters.load(std::memory_order_relaxed); }
+
+    private:
+        /**
+         * @brief Pairs with the fence in PrepareWait(): either the waiter sees
+         *        the notifier's state change, or the notifier sees the waiter.
+         */
+        bool HasWaiters() const
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return m_waiters.load(std::memory_order_relaxed) != 0;
+        }
+
+        alignas(64) std::atomic<uint32_t> m_epoch{0};   ///< Bumped by every effective notification.
+        alignas(64) std::atomic<uint32_t> m_waiters{0}; ///< Threads between PrepareWait() and Wait()/CancelWait().
+    };
+} // namespace cp
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "cp_framework/threading/job.hpp"
+#include "cp_framework/threading/threadPool.hpp"
+
+namespace cp
+{
+    class JobCounter;
+
+    /**
+     * @struct FiberConfig
+     * @brief Construction options for FiberScheduler.
+     *
+     * @ingroup Threading
+     */
+    struct FiberConfig
+    {
+        size_t fiberCount = 64;       ///< Fibers (and stacks) created up front; more are added on demand.
+        size_t stackSize = 64 * 1024; ///< Usable stack bytes per fiber (rounded up to whole pages).
+    };
+
+    /**
+     * @class FiberScheduler
+     * @brief Fiber-based job system running on ThreadPool workers.
+     *
+     * Every job runs on its own fiber (a user-mode stack) taken from a
+     * recycled pool. Inside a job, WaitForCounter() does not block the
+     * worker: the fiber is suspended, the worker goes back to the pool, and
+     * the fiber is resumed (possibly on another worker) by the job that
+     * brings the counter down. Deep dependency chains therefore never tie up
+     * OS threads, in the style of Naughty Dog's fiber job system:
+     * @code
+     * FiberScheduler fibers(pool);
+     * JobCounter counter;
+     * fibers.Run([&] {
+     *     JobCounter children;
+     *     for (auto &mesh : meshes)
+     *         fibers.Run([&mesh] { mesh.Skin(); }, &children);
+     *     fibers.WaitForCounter(children);   // suspends this fiber only
+     *     BuildDrawLists();
+     * }, &counter);
+     * fibers.WaitForCounter(counter);        // outside a fiber: helps the pool
+     * @endcode
+     *
+     * Context switches use ucontext on POSIX and Win32 fibers on Windows.
+     * POSIX stacks are mmap'ed with a PROT_NONE guard page below them, so a
+     * stack overflow faults instead of corrupting a neighbour.
+     *
+     * @note Fiber jobs must not throw, and must not hold a lock or rely on
+     *       thread_local state across WaitForCounter(): the fiber may resume
+     *       on a different thread.
+     *
+     * @ingroup Threading
+     */
+    class CP_API FiberScheduler
+    {
+    public:
+        /**
+         * @brief Creates the scheduler and its initial fiber pool.
+         *
+         * @param pool Pool whose workers run the fibers.
+         * @param config Fiber count and stack size.
+         */
+        explicit FiberScheduler(ThreadPool &pool, const FiberConfig &config = {});
+
+        /**
+         * @brief Waits for every job started through this scheduler and frees the fibers.
+         */
+        ~FiberScheduler();
+
+        FiberScheduler(const FiberScheduler &) = delete;
+        FiberScheduler &operator=(const FiberScheduler &) = delete;
+
+        /**
+         * @brief Runs @p f as a fiber job.
+         *
+         * @param f Callable to run. Must not throw.
+         * @param counter Optional counter incremented now and decremented when @p f returns,
+         *                or when the job is dropped without running (e.g. by ThreadPool::Shutdown()).
+         * @param priority Lane of the pool job that starts the fiber.
+         *
+         * @throws std::runtime_error if the pool is no longer running.
+         */
+        template <typename Func>
+        void Run(Func &&f, JobCounter *counter = nullptr, TaskPriority priority = TaskPriority::NORMAL);
+
+        /**
+         * @brief Waits until @p counter is at most @p target.
+         *
+         * Inside a fiber job of this scheduler the fiber is suspended and the
+         * worker thread is released. Anywhere else the caller runs pool
+         * tasks until the condition holds (see ThreadPool::WaitUntil()).
+         */
+        void WaitForCounter(JobCounter &counter, int64_t target = 0);
+
+        /**
+         * @brief Returns whether the caller is running inside a fiber of this scheduler.
+         */
+        bool InFiber() const;
+
+        /**
+         * @brief Returns the number of fibers created so far.
+         */
+        size_t GetFiberCount() const { return m_fiberCount.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Returns the number of fiber switches performed (in and out).
+         */
+        uint64_t GetSwitchCount() const { return m_switchCount.load(std::memory_order_relaxed); }
+
+    private:
+        friend class JobCounter;
+        struct Fiber;
+
+        /**
+         * @brief Holds a Run() job's counts until its fiber starts; settles them if the pool job is destroyed unrun.
+         */
+        struct PendingLaunch
+        {
+            PendingLaunch(FiberScheduler &owner, JobCounter *jobCounter);
+            PendingLaunch(PendingLaunch &&other) noexcept
+                : scheduler(std::exchange(other.scheduler, nullptr)), counter(other.counter) {}
+            PendingLaunch &operator=(PendingLaunch &&) = delete;
+            ~PendingLaunch();
+
+            /**
+             * @brief Hands the counts over to a fiber running @p body.
+             */
+            void Start(Job &&body) { std::exchange(scheduler, nullptr)->Launch(std::move(body), counter); }
+
+            FiberScheduler *scheduler; ///< Scheduler still owed the job, nullptr once started or moved from.
+            JobCounter *counter;       ///< Counter of the job, if any.
+        };
+
+        /**
+         * @brief Starts @p body on a pooled fiber. Runs on the thread that picked up the job.
+         */
+        void Launch(Job &&body, JobCounter *counter);
+
+        /**
+         * @brief Switches into @p fiber and handles the state it comes back in.
+         */
+        void Resume(Fiber *fiber);
+
+        /**
+         * @brief Files a fiber that switched out to wait; returns false if its wait is already over.
+         */
+        bool Park(Fiber *fiber);
+
+        /**
+         * @brief Decrements @p counter and resumes the fibers whose wait is over.
+         *
+         * Never throws, since it runs on fiber stacks: a fiber whose resume
+         * cannot be dispatched is failed with FailFiber().
+         */
+        void Signal(JobCounter &counter);
+
+        /**
+         * @brief Settles a job that will never finish: signals its @p counter and drops it from m_active.
+         */
+        void Abandon(JobCounter *counter);
+
+        /**
+         * @brief Gives up on a suspended fiber that cannot be resumed.
+         *
+         * The job is abandoned and its stack is never recycled; it is freed
+         * with the scheduler.
+         */
+        void FailFiber(Fiber *fiber);
+
+        Fiber *AcquireFiber();
+        void ReleaseFiber(Fiber *fiber);
+        Fiber *CreateFiber();
+        static void DestroyFiber(Fiber *fiber);
+
+        /**
+         * @brief Entry point of every fiber: runs jobs until the fiber is destroyed.
+         */
+        static void FiberMain(Fiber *fiber);
+
+        ThreadPool &m_pool;                     ///< Pool running the fibers.
+        FiberConfig m_config;                   ///< Construction options.
+        std::mutex m_fiberMutex;                ///< Guards the free list and m_fibers.
+        Fiber *m_freeFibers = nullptr;          ///< Idle fibers.
+        std::vector<Fiber *> m_fibers;          ///< Every fiber, for destruction.
+        std::atomic<size_t> m_fiberCount{0};    ///< Fibers created so far.
+        std::atomic<size_t> m_active{0};        ///< Jobs started and not finished.
+        std::atomic<uint64_t> m_switchCount{0}; ///< Context switches performed.
+    };
+
+    /**
+     * @class JobCounter
+     * @brief Atomic counter tracking fiber jobs, with a list of fibers waiting on it.
+     *
+     * FiberScheduler::Run() increments the counter passed to it and the job
+     * decrements it on completion. FiberScheduler::WaitForCounter() suspends
+     * the calling fiber until the counter dropped to a target value.
+     *
+     * A counter must outlive every job and wait that references it.
+     *
+     * @ingroup Threading
+     */
+    class JobCounter
+    {
+    public:
+        JobCounter() = default;
+        JobCounter(const JobCounter &) = delete;
+        JobCounter &operator=(const JobCounter &) = delete;
+
+        /**
+         * @brief Returns the number of unfinished jobs.
+         */
+        int64_t Value() const { return m_value.load(std::memory_order_acquire); }
+
+    private:
+        friend class FiberScheduler;
+
+        std::atomic<int64_t> m_value{0};            ///< Unfinished jobs.
+        std::atomic<uint32_t> m_waiterCount{0};     ///< Fibers parked (or parking) on this counter.
+        std::mutex m_mutex;                         ///< Guards m_waiters.
+        FiberScheduler::Fiber *m_waiters = nullptr; ///< Intrusive list of parked fibers.
+    };
+
+    inline FiberScheduler::PendingLaunch::PendingLaunch(FiberScheduler &owner, JobCounter *jobCounter)
+        : scheduler(&owner), counter(jobCounter)
+    {
+        if (counter)
+            counter->m_value.fetch_add(1, std::memory_order_relaxed);
+        owner.m_active.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline FiberScheduler::PendingLaunch::~PendingLaunch()
+    {
+        if (scheduler)
+            scheduler->Abandon(counter);
+    }
+
+    template <typename Func>
+    void FiberScheduler::Run(Func &&f, JobCounter *counter, TaskPriority priority)
+    {
+        // Also settles the counts if Dispatch() throws.
+        m_pool.Dispatch(priority, [launch = PendingLaunch(*this, counter), fn = std::forward<Func>(f)]() mutable
+                        { launch.Start(Job(std::move(fn))); });
+    }
+} // namespace cp
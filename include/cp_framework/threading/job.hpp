@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace cp
+{
+    /**
+     * @class Job
+     * @brief Move-only, type-erased `void()` callable with inline small-buffer storage.
+     *
+     * Callables up to kInlineSize bytes (with nothrow move construction and
+     * default alignment) are stored inline and never touch the heap. Larger
+     * callables fall back to a single heap allocation.
+     *
+     * Unlike std::function, Job accepts move-only callables (e.g. a
+     * std::packaged_task or a lambda owning a unique_ptr) and does not
+     * require copyability.
+     *
+     * @ingroup Threading
+     */
+    class Job
+    {
+    public:
+        /// @brief Number of bytes available for inline callable storage.
+        static constexpr size_t kInlineSize = 48;
+
+        /**
+         * @brief Constructs an empty job.
+         */
+        Job() noexcept = default;
+
+        /**
+         * @brief Constructs a job from any `void()`-invocable callable.
+         *
+         * @tparam F Callable type.
+         * @param f Callable to store. Moved or copied into the job.
+         */
+        template <typename F,
+                  typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Job> &&
+                                              std::is_invocable_v<std::decay_t<F> &>>>
+        Job(F &&f)
+        {
+            using Fn = std::decay_t<F>;
+            if constexpr (FitsInline<Fn>())
+            {
+                ::new (static_cast<void *>(m_storage)) Fn(std::forward<F>(f));
+                m_ops = &InlineOps<Fn>::ops;
+            }
+            else
+            {
+                ::new (static_cast<void *>(m_storage)) Fn *(new Fn(std::forward<F>(f)));
+                m_ops = &HeapOps<Fn>::ops;
+            }
+        }
+
+        Job(Job &&other) noexcept { MoveFrom(other); }
+
+        Job &operator=(Job &&other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                MoveFrom(other);
+            }
+            return *this;
+        }
+
+        Job(const Job &) = delete;
+        Job &operator=(const Job &) = delete;
+
+        ~Job() { Reset(); }
+
+        /**
+         * @brief Invokes the stored callable. The job must not be empty.
+         */
+        void operator()() { m_ops->invoke(m_storage); }
+
+        /**
+         * @brief Returns whether a callable is stored.
+         */
+        explicit operator bool() const noexcept { return m_ops != nullptr; }
+
+        /**
+         * @brief Destroys the stored callable, leaving the job empty.
+         */
+        void Reset() noexcept
+        {
+            if (m_ops)
+            {
+                m_ops->destroy(m_storage);
+                m_ops = nullptr;
+            }
+        }
+
+        /**
+         * @brief Returns whether a callable of type F would be stored without allocating.
+         */
+        template <typename F>
+        static constexpr bool FitsInline()
+        {
+            return sizeof(F) <= kInlineSize &&
+                   alignof(F) <= alignof(std::max_align_t) &&
+                   std::is_nothrow_move_constructible_v<F>;
+        }
+
+    private:
+        /**
+         * @brief Manual vtable for the stored callable.
+         */
+        struct Ops
+        {
+            void (*invoke)(void *storage);
+            void (*relocate)(void *dst, void *src) noexcept; ///< Move-constructs into dst and destroys src.
+            void (*destroy)(void *storage) noexcept;
+        };
+
+        template <typename Fn>
+        struct InlineOps
+        {
+            static void Invoke(void *s) { (*std::launder(static_cast<Fn *>(s)))(); }
+            static void Relocate(void *dst, void *src) noexcept
+            {
+                Fn *from = std::launder(static_cast<Fn *>(src));
+                ::new (dst) Fn(std::move(*from));
+                from->~Fn();
+            }
+            static void Destroy(void *s) noexcept { std::launder(static_cast<Fn *>(s))->~Fn(); }
+
+            static constexpr Ops ops{&Invoke, &Relocate, &Destroy};
+        };
+
+        template <typename Fn>
+        struct HeapOps
+        {
+            static Fn *&Ptr(void *s) { return *std::launder(static_cast<Fn **>(s)); }
+            static void Invoke(void *s) { (*Ptr(s))(); }
+            static void Relocate(void *dst, void *src) noexcept { ::new (dst) Fn *(Ptr(src)); }
+            static void Destroy(void *s) noexcept { delete Ptr(s); }
+
+            static constexpr Ops ops{&Invoke, &Relocate, &Destroy};
+        };
+
+        void MoveFrom(Job &other) noexcept
+        {
+            if (other.m_ops)
+            {
+                other.m_ops->relocate(m_storage, other.m_storage);
+                m_ops = other.m_ops;
+                other.m_ops = nullptr;
+            }
+        }
+
+        alignas(std::max_align_t) unsigned char m_storage[kInlineSize]; ///< Inline callable (or heap pointer).
+        const Ops *m_ops = nullptr;                                      ///< Null when empty.
+    };
+} // namespace cp
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <utility>
+#include "cp_framework/threading/threadPool.hpp"
+
+namespace cp
+{
+    /**
+     * @class JobFence
+     * @brief Counts jobs dispatched through it so a thread can wait for all of them.
+     *
+     * The fence is a single atomic counter: Dispatch() increments it and the
+     * job decrements it when done. Wait() blocks until the counter drops to
+     * zero while running pool tasks on the calling thread, so the waiter
+     * contributes to the work instead of idling. The fence can be reused as
+     * soon as Wait() returned; no allocation happens per cycle as long as
+     * the jobs fit in a Job.
+     *
+     * Framework owns one per frame: jobs kicked off in update() or
+     * fixedUpdate() are joined before lateUpdate().
+     * @code
+     * JobFence &jobs = framework.GetFrameJobs();
+     * for (auto &chunk : particleChunks)
+     *     jobs.Dispatch([&chunk, dt] { chunk.Simulate(dt); });
+     * // Framework::Run waits on the fence before lateUpdate()
+     * @endcode
+     *
+     * @ingroup Threading
+     */
+    class JobFence
+    {
+    public:
+        /**
+         * @brief Creates a fence dispatching to @p pool.
+         */
+        explicit JobFence(ThreadPool &pool) : m_pool(pool) {}
+
+        /**
+         * @brief Waits for outstanding jobs; their errors are discarded.
+         */
+        ~JobFence()
+        {
+            m_pool.WaitUntil([this]
+                             { return IsComplete(); });
+        }
+
+        JobFence(const JobFence &) = delete;
+        JobFence &operator=(const JobFence &) = delete;
+
+        /**
+         * @brief Dispatches a job tracked by this fence.
+         *
+         * An exception thrown by the job is captured and rethrown by the
+         * next Wait() (first one wins). A job destroyed without running,
+         * e.g. left over by ThreadPool::Shutdown(), counts as finished.
+         *
+         * @param f Callable to run.
+         * @param priority Scheduling priority.
+         *
+         * @throws std::runtime_error if the pool is no longer running.
+         */
+        template <typename Func>
+        void Dispatch(Func &&f, TaskPriority priority = TaskPriority::NORMAL)
+        {
+            const int lane = static_cast<int>(priority);
+            int lowest = m_lowestLane.load(std::memory_order_relaxed);
+            while (lane > lowest && !m_lowestLane.compare_exchange_weak(lowest, lane, std::memory_order_relaxed))
+            {
+            }
+
+            // The ticket settles the count even if the job never runs or Dispatch() throws.
+            m_pool.Dispatch(priority, [ticket = Ticket(*this), fn = std::forward<Func>(f)]() mutable
+                            {
+                                try
+                                {
+                                    fn();
+                                }
+                                catch (...)
+                                {
+                                    ticket.fence->Fail();
+                                }
+                                ticket.Release(); });
+        }
+
+        /**
+         * @brief Waits until every dispatched job finished, running pool tasks meanwhile.
+         *
+         * Outside the pool, only tasks of the lowest priority dispatched since
+         * the last Wait() or higher are picked up.
+         *
+         * Rethrows the first exception thrown by a job since the last Wait().
+         */
+        void Wait()
+        {
+            const auto lowest = static_cast<TaskPriority>(m_lowestLane.exchange(0, std::memory_order_relaxed));
+            m_pool.WaitUntil([this]
+                             { return IsComplete(); },
+                             lowest);
+
+            std::exception_ptr error;
+            {
+                std::lock_guard<std::mutex> lock(m_errorMutex);
+                error = std::exchange(m_error, nullptr);
+            }
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+        /**
+         * @brief Returns whether no dispatched job is outstanding.
+         */
+        bool IsComplete() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+        /**
+         * @brief Returns the number of outstanding jobs.
+         */
+        size_t Pending() const { return m_pending.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Returns the pool the jobs run on.
+         */
+        ThreadPool &GetPool() const { return m_pool; }
+
+    private:
+        /**
+         * @brief One outstanding job of the fence, released once when the job finishes or is destroyed.
+         */
+        struct Ticket
+        {
+            explicit Ticket(JobFence &owner) : fence(&owner) { fence->m_pending.fetch_add(1, std::memory_order_relaxed); }
+            Ticket(Ticket &&other) noexcept : fence(std::exchange(other.fence, nullptr)) {}
+            Ticket &operator=(Ticket &&) = delete;
+            ~Ticket() { Release(); }
+
+            void Release()
+            {
+                if (fence)
+                    std::exchange(fence, nullptr)->m_pending.fetch_sub(1, std::memory_order_release);
+            }
+
+            JobFence *fence; ///< Fence to release, nullptr once released or moved from.
+        };
+
+        /**
+         * @brief Records the in-flight exception (first one wins).
+         */
+        void Fail()
+        {
+            std::lock_guard<std::mutex> lock(m_errorMutex);
+            if (!m_error)
+                m_error = std::current_exception();
+        }
+
+        ThreadPool &m_pool;                ///< Pool executing the jobs.
+        std::atomic<size_t> m_pending{0};  ///< Jobs dispatched and not finished yet.
+        std::atomic<int> m_lowestLane{0};  ///< Lowest priority (highest lane) dispatched since the last Wait().
+        std::mutex m_errorMutex;           ///< Guards m_error.
+        std::exception_ptr m_error;        ///< First exception thrown by a job.
+    };
+} // namespace cp
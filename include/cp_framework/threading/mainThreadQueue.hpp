@@ -0,0 +1,182 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <functional>
+#include <future>
+#include <thread>
+#include <utility>
+#include "cp_framework/core/export.hpp"
+#include "cp_framework/threading/job.hpp"
+
+namespace cp
+{
+    /**
+     * @class MainThreadQueue
+     * @brief Lock-free multi-producer queue of work that must run on the main thread.
+     *
+     * GLFW calls, Window operations and swapchain recreation are only legal
+     * on the main thread. Any thread may hand such work over with Post() or
+     * Submit(); the main thread runs it from Drain(), which Framework::Run
+     * calls once per frame with a time budget:
+     * @code
+     * pool.Dispatch(TaskPriority::LOW, [&] {
+     *     Image icon = DecodeIcon(path);
+     *     mainQueue.Post([&window, icon = std::move(icon)] { window.SetIcon(icon); });
+     * });
+     * @endcode
+     *
+     * Coroutines can hop over and back:
+     * @code
+     * Task<> ApplySettings(ThreadPool &pool, MainThreadQueue &main) {
+     *     Settings s = LoadSettings();          // on a worker
+     *     co_await main.Schedule();             // now on the main thread
+     *     window.SetMode(s.mode);
+     *     co_await pool.Schedule();             // back on a worker
+     * }
+     * @endcode
+     *
+     * The queue is an intrusive Vyukov MPSC list: posting is one atomic
+     * exchange plus one store, with no lock and no CAS loop, and the main
+     * thread pops without any atomic read-modify-write.
+     *
+     * @ingroup Threading
+     */
+    class CP_API MainThreadQueue
+    {
+    public:
+        /**
+         * @brief Creates the queue; the calling thread becomes its main thread.
+         */
+        MainThreadQueue();
+
+        /**
+         * @brief Destroys queued tasks without running them.
+         *
+         * Futures of dropped Submit() tasks report std::future_errc::broken_promise.
+         * Coroutines suspended on Schedule() are never resumed, so the queue
+         * must outlive every producer.
+         */
+        ~MainThreadQueue();
+
+        MainThreadQueue(const MainThreadQueue &) = delete;
+        MainThreadQueue &operator=(const MainThreadQueue &) = delete;
+
+        /**
+         * @brief Queues a fire-and-forget task for the main thread.
+         *
+         * Thread-safe and lock-free. An exception escaping @p f propagates
+         * out of Drain() on the main thread.
+         *
+         * @param f Callable to run.
+         */
+        template <typename Func>
+        void Post(Func &&f) { Push(Job(std::forward<Func>(f))); }
+
+        /**
+         * @brief Queues a task for the main thread and returns a future of its result.
+         *
+         * Exceptions are stored in the future. From a pool task, wait on it
+         * with ThreadPool::Wait() rather than future.get(), or switch threads
+         * with `co_await Schedule()` instead.
+         *
+         * @param f Callable to run.
+         * @return Future holding the callable's result.
+         */
+        template <typename Func>
+        auto Submit(Func &&f) -> std::future<std::invoke_result_t<std::decay_t<Func> &>>
+        {
+            using ReturnType = std::invoke_result_t<std::decay_t<Func> &>;
+
+            std::packaged_task<ReturnType()> task(std::forward<Func>(f));
+            std::future<ReturnType> future = task.get_future();
+            Push(Job([task = std::move(task)]() mutable
+                     { task(); }));
+            return future;
+        }
+
+        /**
+         * @brief Awaiter moving a coroutine onto the main thread.
+         */
+        class ScheduleAwaiter
+        {
+        public:
+            explicit ScheduleAwaiter(MainThreadQueue &queue) : m_queue(queue) {}
+
+            /// @brief Already on the main thread: continue without a round trip.
+            bool await_ready() const noexcept { return m_queue.IsMainThread(); }
+
+            /**
+             * @brief Queues the suspended coroutine's resumption for the next Drain().
+             */
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                m_queue.Post([handle]
+                             { handle.resume(); });
+            }
+
+            void await_resume() const noexcept {}
+
+        private:
+            MainThreadQueue &m_queue; ///< Queue that resumes the coroutine.
+        };
+
+        /**
+         * @brief Moves the awaiting coroutine onto the main thread.
+         *
+         * `co_await queue.Schedule()` resumes the coroutine from the next
+         * Drain(), or continues immediately when already on the main thread.
+         */
+        ScheduleAwaiter Schedule() { return ScheduleAwaiter(*this); }
+
+        /**
+         * @brief Runs queued tasks on the main thread until the queue or the budget is exhausted.
+         *
+         * Only tasks queued before the call are considered; tasks they post
+         * run in the next Drain(), so a task re-posting itself cannot spin
+         * forever. At least one task runs per call (if any is queued), so a
+         * tiny budget still makes progress; the budget is checked between
+         * tasks, never inside one.
+         *
+         * @param budget Time after which remaining tasks are left for the next call.
+         * @return Number of tasks run.
+         */
+        size_t Drain(std::chrono::nanoseconds budget = std::chrono::nanoseconds::max());
+
+        /**
+         * @brief Returns whether the caller is the queue's main thread.
+         */
+        bool IsMainThread() const { return std::this_thread::get_id() == m_mainThread; }
+
+        /**
+         * @brief Returns the approximate number of queued tasks.
+         */
+        size_t Pending() const { return m_pending.load(std::memory_order_relaxed); }
+
+    private:
+        struct Node;
+
+        /**
+         * @brief Links a job at the producer end. Thread-safe.
+         */
+        void Push(Job &&job);
+
+        /**
+         * @brief Links a node at the producer end.
+         */
+        void PushNode(Node *node);
+
+        /**
+         * @brief Unlinks the oldest node, or returns nullptr if the queue is empty
+         *        or a producer is half-way through Push(). Main thread only.
+         */
+        Node *Pop();
+
+        alignas(64) std::atomic<Node *> m_head; ///< Producer end (newest node).
+        alignas(64) Node *m_tail;               ///< Consumer end (oldest node); main thread only.
+        Node *m_stub;                           ///< Placeholder keeping the list non-empty.
+        std::atomic<size_t> m_pending{0};       ///< Queued tasks.
+        std::thread::id m_mainThread;           ///< Thread allowed to Drain().
+    };
+} // namespace cp
@@ -0,0 +1,547 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "cp_framework/threading/threadPool.hpp"
+
+/**
+ * @brief Parallel counterparts of common <algorithm>/<numeric> routines, built on ThreadPool.
+ *
+ * Every algorithm cuts its input into a few blocks per worker, processes
+ * them with ThreadPool::ParallelFor() (the calling thread takes part) and
+ * falls back to the sequential std algorithm below kSequentialThreshold
+ * elements or on a single-threaded pool, where the fork overhead would
+ * dominate.
+ *
+ * Algorithms that move elements through a scratch buffer require nothrow
+ * move construction. Comparators, keys, predicates and operators must not
+ * throw; if one does, the exception is rethrown and the range is left in a
+ * valid but unspecified state.
+ *
+ * @ingroup Threading
+ */
+namespace cp::parallel
+{
+    /// @brief Inputs shorter than this are handed to the sequential std algorithm.
+    inline constexpr size_t kSequentialThreshold = size_t(1) << 14;
+
+    namespace detail
+    {
+        /// @brief Smallest block processed by one task.
+        inline constexpr size_t kMinBlockSize = size_t(1) << 12;
+
+        /**
+         * @brief Number of blocks for @p n elements: about four per worker, none below kMinBlockSize.
+         */
+        inline size_t BlockCount(const ThreadPool &pool, size_t n)
+        {
+            const size_t byThreads = std::max<size_t>(1, pool.GetThreadCount()) * 4;
+            return std::max<size_t>(1, std::min(byThreads, n / kMinBlockSize));
+        }
+
+        /**
+         * @brief First element of @p block when @p n elements are cut into @p blocks even blocks.
+         */
+        inline size_t BlockBegin(size_t n, size_t blocks, size_t block) { return n * block / blocks; }
+
+        /**
+         * @brief Whether a sequential fallback is cheaper than forking.
+         */
+        inline bool RunSequential(const ThreadPool &pool, size_t n)
+        {
+            return n < kSequentialThreshold || pool.GetThreadCount() <= 1;
+        }
+
+        /**
+         * @brief Uninitialized storage that takes over a range's elements by move, in parallel.
+         */
+        template <typename T>
+        class ScratchBuffer
+        {
+            static_assert(std::is_nothrow_move_constructible_v<T>,
+                          "cp::parallel algorithms need nothrow-move-constructible elements");
+
+        public:
+            template <typename RandomIt>
+            ScratchBuffer(ThreadPool &pool, RandomIt first, size_t n, size_t blocks)
+                : m_data(std::allocator<T>().allocate(n)),
+                  m_size(n)
+            {
+                try
+                {
+                    pool.ParallelFor(0, blocks, 1, [&](size_t block)
+                                     {
+                                         const size_t begin = BlockBegin(n, blocks, block);
+                                         const size_t end = BlockBegin(n, blocks, block + 1);
+                                         std::uninitialized_move(first + begin, first + end, m_data + begin); });
+                }
+                catch (...)
+                {
+                    // ParallelFor only throws before running anything (pool shut down).
+                    std::allocator<T>().deallocate(m_data, m_size);
+                    throw;
+                }
+            }
+
+            ~ScratchBuffer()
+            {
+                std::destroy_n(m_data, m_size);
+                std::allocator<T>().deallocate(m_data, m_size);
+            }
+
+            ScratchBuffer(const ScratchBuffer &) = delete;
+            ScratchBuffer &operator=(const ScratchBuffer &) = delete;
+
+            T *Data() const { return m_data; }
+
+        private:
+            T *m_data;     ///< Storage for m_size elements, all constructed.
+            size_t m_size; ///< Element count.
+        };
+
+        /**
+         * @brief Moves every block of @p src to the same position in @p dst, in parallel.
+         */
+        template <typename SrcIt, typename DstIt>
+        void MoveBlocks(ThreadPool &pool, SrcIt src, DstIt dst, size_t n, size_t blocks)
+        {
+            pool.ParallelFor(0, blocks, 1, [&](size_t block)
+                             {
+                                 const size_t begin = BlockBegin(n, blocks, block);
+                                 const size_t end = BlockBegin(n, blocks, block + 1);
+                                 std::move(src + begin, src + end, dst + begin); });
+        }
+
+        /**
+         * @brief Maps an integral key to an unsigned one with the same order (sign bit flipped for signed keys).
+         */
+        template <typename Key>
+        constexpr std::make_unsigned_t<Key> RadixBits(Key key)
+        {
+            using Bits = std::make_unsigned_t<Key>;
+            if constexpr (std::is_signed_v<Key>)
+                return static_cast<Bits>(static_cast<Bits>(key) ^ (Bits(1) << (sizeof(Bits) * 8 - 1)));
+            else
+                return static_cast<Bits>(key);
+        }
+
+        /**
+         * @brief Whether Sort() may use radix sort: plain integers under the default ordering.
+         */
+        template <typename T, typename Compare>
+        inline constexpr bool kRadixSortable =
+            std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+            (std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>);
+
+        /**
+         * @brief Parallel stable LSD radix sort on an integral key, one byte per pass.
+         *
+         * Each pass builds per-block digit histograms in parallel, turns them
+         * into per-block output offsets (digit-major, so the sort is stable)
+         * and scatters the blocks in parallel. Passes whose digit is the same
+         * for every key are skipped, so small key ranges cost fewer passes.
+         */
+        template <typename RandomIt, typename KeyFn>
+        void RadixSort(ThreadPool &pool, RandomIt first, size_t n, KeyFn &keyOf)
+        {
+            using T = typename std::iterator_traits<RandomIt>::value_type;
+            using Key = std::decay_t<std::invoke_result_t<KeyFn &, const T &>>;
+            static_assert(std::is_integral_v<Key> && !std::is_same_v<Key, bool>, "radix sort keys must be integers");
+
+            const size_t blocks = BlockCount(pool, n);
+            std::vector<std::array<size_t, 256>> counts(blocks);
+
+            ScratchBuffer<T> buffer(pool, first, n, blocks);
+            T *scratch = buffer.Data();
+            bool inBuffer = true;
+
+            auto pass = [&](auto src, auto dst, uint32_t shift) -> bool
+            {
+                pool.ParallelFor(0, blocks, 1, [&](size_t block)
+                                 {
+                                     std::array<size_t, 256> &count = counts[block];
+                                     count.fill(0);
+                                     const size_t end = BlockBegin(n, blocks, block + 1);
+                                     for (size_t i = BlockBegin(n, blocks, block); i < end; ++i)
+                                         ++count[(RadixBits(keyOf(src[i])) >> shift) & 0xFF]; });
+
+                size_t running = 0;
+                for (size_t digit = 0; digit < 256; ++digit)
+                {
+                    size_t total = 0;
+                    for (size_t block = 0; block < blocks; ++block)
+                        total += counts[block][digit];
+                    if (total == n)
+                        return false;
+
+                    for (size_t block = 0; block < blocks; ++block)
+                    {
+                        const size_t count = counts[block][digit];
+                        counts[block][digit] = running;
+                        running += count;
+                    }
+                }
+
+                pool.ParallelFor(0, blocks, 1, [&](size_t block)
+                                 {
+                                     std::array<size_t, 256> &offset = counts[block];
+                                     const size_t end = BlockBegin(n, blocks, block + 1);
+                                     for (size_t i = BlockBegin(n, blocks, block); i < end; ++i)
+                                         dst[offset[(RadixBits(keyOf(src[i])) >> shift) & 0xFF]++] = std::move(src[i]); });
+                return true;
+            };
+
+            for (uint32_t shift = 0; shift < sizeof(Key) * 8; shift += 8)
+            {
+                const bool moved = inBuffer ? pass(scratch, first, shift) : pass(first, scratch, shift);
+                if (moved)
+                    inBuffer = !inBuffer;
+            }
+
+            if (inBuffer)
+                MoveBlocks(pool, scratch, first, n, blocks);
+        }
+
+        /**
+         * @brief Number of elements taken from @p a among the first @p k outputs of a stable merge.
+         *
+         * Binary search along the merge path; ties go to @p a, like std::merge.
+         */
+        template <typename It, typename Compare>
+        size_t MergeCoRank(size_t k, It a, size_t na, It b, size_t nb, Compare &comp)
+        {
+            size_t lo = k > nb ? k - nb : 0;
+            size_t hi = std::min(k, na);
+            while (lo < hi)
+            {
+                const size_t i = lo + (hi - lo) / 2;
+                const size_t j = k - i;
+                if (j > 0 && !comp(b[j - 1], a[i]))
+                    lo = i + 1;
+                else
+                    hi = i;
+            }
+            return lo;
+        }
+
+        /**
+         * @brief Parallel merge sort: sorts blocks in parallel, then merges runs pairwise.
+         *
+         * Every merge round is cut along the merge path into as many pieces
+         * as there are blocks, so the last rounds (few, long runs) stay as
+         * parallel as the first ones.
+         */
+        template <bool Stable, typename RandomIt, typename Compare>
+        void MergeSort(ThreadPool &pool, RandomIt first, size_t n, Compare &comp)
+        {
+            using T = typename std::iterator_traits<RandomIt>::value_type;
+
+            const size_t blocks = BlockCount(pool, n);
+            pool.ParallelFor(0, blocks, 1, [&](size_t block)
+                             {
+                                 RandomIt begin = first + BlockBegin(n, blocks, block);
+                                 RandomIt end = first + BlockBegin(n, blocks, block + 1);
+                                 if constexpr (Stable)
+                                     std::stable_sort(begin, end, comp);
+                                 else
+                                     std::sort(begin, end, comp); });
+            if (blocks == 1)
+                return;
+
+            ScratchBuffer<T> buffer(pool, first, n, blocks);
+            T *scratch = buffer.Data();
+            bool inBuffer = true;
+
+            auto round = [&](auto src, auto dst, size_t width)
+            {
+                const size_t span = 2 * width;
+                const size_t pairs = (blocks + span - 1) / span;
+                const size_t pieces = std::max<size_t>(1, blocks / pairs);
+
+                auto bounds = [&](size_t pair, size_t &lo, size_t &mid, size_t &hi)
+                {
+                    lo = BlockBegin(n, blocks, std::min(pair * span, blocks));
+                    mid = BlockBegin(n, blocks, std::min(pair * span + width, blocks));
+                    hi = BlockBegin(n, blocks, std::min(pair * span + span, blocks));
+                };
+
+                // Split points are found before anything moves: moving out of src
+                // modifies it (strings, owning pointers), which a neighbouring
+                // piece's binary search would otherwise read.
+                std::vector<size_t> splits(pairs * pieces);
+                pool.ParallelFor(0, pairs * pieces, 1, [&](size_t task)
+                                 {
+                                     size_t lo, mid, hi;
+                                     bounds(task / pieces, lo, mid, hi);
+                                     const size_t k = (hi - lo) * (task % pieces) / pieces;
+                                     splits[task] = MergeCoRank(k, src + lo, mid - lo, src + mid, hi - mid, comp); });
+
+                pool.ParallelFor(0, pairs * pieces, 1, [&](size_t task)
+                                 {
+                                     const size_t piece = task % pieces;
+                                     size_t lo, mid, hi;
+                                     bounds(task / pieces, lo, mid, hi);
+
+                                     const size_t total = hi - lo;
+                                     const size_t kBegin = total * piece / pieces;
+                                     const size_t kEnd = total * (piece + 1) / pieces;
+                                     const size_t i0 = splits[task];
+                                     const size_t i1 = piece + 1 < pieces ? splits[task + 1] : mid - lo;
+
+                                     // std::merge with moves; comp sees lvalues like in std::sort.
+                                     auto ai = src + lo + i0, aEnd = src + lo + i1;
+                                     auto bi = src + mid + (kBegin - i0), bEnd = src + mid + (kEnd - i1);
+                                     auto out = dst + lo + kBegin;
+                                     while (ai != aEnd && bi != bEnd)
+                                         *out++ = comp(*bi, *ai) ? std::move(*bi++) : std::move(*ai++);
+                                     out = std::move(ai, aEnd, out);
+                                     std::move(bi, bEnd, out); });
+            };
+
+            for (size_t width = 1; width < blocks; width *= 2)
+            {
+                if (inBuffer)
+                    round(scratch, first, width);
+                else
+                    round(first, scratch, width);
+                inBuffer = !inBuffer;
+            }
+
+            if (inBuffer)
+                MoveBlocks(pool, scratch, first, n, blocks);
+        }
+    }
+
+    /**
+     * @brief Sorts [first, last) in parallel; a drop-in for std::sort.
+     *
+     * Integers under the default ordering use a parallel LSD radix sort
+     * (one byte per pass, O(n) work); everything else uses a parallel merge
+     * sort. Not guaranteed to be stable, see StableSort().
+     * @code
+     * parallel::Sort(pool, drawKeys.begin(), drawKeys.end());
+     * parallel::Sort(pool, entities.begin(), entities.end(),
+     *                [](const Entity &a, const Entity &b) { return a.depth < b.depth; });
+     * @endcode
+     *
+     * @param pool Pool running the work.
+     * @param first Start of the range (random access).
+     * @param last End of the range.
+     * @param comp Strict weak ordering.
+     */
+    template <typename RandomIt, typename Compare = std::less<>>
+    void Sort(ThreadPool &pool, RandomIt first, RandomIt last, Compare comp = {})
+    {
+        using T = typename std::iterator_traits<RandomIt>::value_type;
+
+        const size_t n = static_cast<size_t>(last - first);
+        if (detail::RunSequential(pool, n))
+        {
+            std::sort(first, last, comp);
+            return;
+        }
+
+        if constexpr (detail::kRadixSortable<T, Compare>)
+        {
+            auto identity = [](const T &value)
+            { return value; };
+            detail::RadixSort(pool, first, n, identity);
+        }
+        else
+        {
+            detail::MergeSort<false>(pool, first, n, comp);
+        }
+    }
+
+    /**
+     * @brief Stable variant of Sort(); a drop-in for std::stable_sort.
+     */
+    template <typename RandomIt, typename Compare = std::less<>>
+    void StableSort(ThreadPool &pool, RandomIt first, RandomIt last, Compare comp = {})
+    {
+        using T = typename std::iterator_traits<RandomIt>::value_type;
+
+        const size_t n = static_cast<size_t>(last - first);
+        if (detail::RunSequential(pool, n))
+        {
+            std::stable_sort(first, last, comp);
+            return;
+        }
+
+        if constexpr (detail::kRadixSortable<T, Compare>)
+        {
+            auto identity = [](const T &value)
+            { return value; };
+            detail::RadixSort(pool, first, n, identity);
+        }
+        else
+        {
+            detail::MergeSort<true>(pool, first, n, comp);
+        }
+    }
+
+    /**
+     * @brief Stably sorts [first, last) by an integer key with a parallel radix sort.
+     *
+     * The natural fit for draw lists and other records ordered by a packed
+     * integer key; O(n) per key byte regardless of the element type.
+     * @code
+     * parallel::SortByKey(pool, draws.begin(), draws.end(), [](const Draw &d) { return d.sortKey; });
+     * @endcode
+     *
+     * @param keyOf Returns the element's integer key; called several times per element.
+     */
+    template <typename RandomIt, typename KeyFn>
+    void SortByKey(ThreadPool &pool, RandomIt first, RandomIt last, KeyFn keyOf)
+    {
+        using T = typename std::iterator_traits<RandomIt>::value_type;
+
+        const size_t n = static_cast<size_t>(last - first);
+        if (detail::RunSequential(pool, n))
+        {
+            std::stable_sort(first, last, [&keyOf](const T &a, const T &b)
+                             { return keyOf(a) < keyOf(b); });
+            return;
+        }
+
+        detail::RadixSort(pool, first, n, keyOf);
+    }
+
+    /**
+     * @brief Parallel std::inclusive_scan (prefix "sum" including each element).
+     *
+     * Two passes over blocks: block totals in parallel, a short sequential
+     * scan of the totals, then every block is scanned from its carry in
+     * parallel. @p op must be associative; it need not be commutative.
+     * @p out may equal @p first.
+     *
+     * @return Iterator one past the last written element.
+     */
+    template <typename InputIt, typename OutputIt, typename BinaryOp = std::plus<>>
+    OutputIt InclusiveScan(ThreadPool &pool, InputIt first, InputIt last, OutputIt out, BinaryOp op = {})
+    {
+        using T = typename std::iterator_traits<InputIt>::value_type;
+
+        const size_t n = static_cast<size_t>(last - first);
+        if (detail::RunSequential(pool, n))
+            return std::inclusive_scan(first, last, out, op);
+
+        const size_t blocks = detail::BlockCount(pool, n);
+        std::vector<T> totals(blocks, *first);
+        pool.ParallelFor(0, blocks, 1, [&](size_t block)
+                         {
+                             const size_t begin = detail::BlockBegin(n, blocks, block);
+                             const size_t end = detail::BlockBegin(n, blocks, block + 1);
+                             totals[block] = std::accumulate(first + begin + 1, first + end, T(first[begin]), op); });
+
+        // totals[b] becomes the prefix up to and including block b.
+        for (size_t block = 1; block < blocks; ++block)
+            totals[block] = op(totals[block - 1], totals[block]);
+
+        pool.ParallelFor(0, blocks, 1, [&](size_t block)
+                         {
+                             const size_t begin = detail::BlockBegin(n, blocks, block);
+                             const size_t end = detail::BlockBegin(n, blocks, block + 1);
+                             if (block == 0)
+                                 std::inclusive_scan(first + begin, first + end, out + begin, op);
+                             else
+                                 std::inclusive_scan(first + begin, first + end, out + begin, op, totals[block - 1]); });
+        return out + n;
+    }
+
+    /**
+     * @brief Parallel std::exclusive_scan (prefix "sum" of the preceding elements, starting at @p init).
+     *
+     * Same two-pass scheme as InclusiveScan(). @p out may equal @p first.
+     *
+     * @return Iterator one past the last written element.
+     */
+    template <typename InputIt, typename OutputIt, typename T, typename BinaryOp = std::plus<>>
+    OutputIt ExclusiveScan(ThreadPool &pool, InputIt first, InputIt last, OutputIt out, T init, BinaryOp op = {})
+    {
+        const size_t n = static_cast<size_t>(last - first);
+        if (detail::RunSequential(pool, n))
+            return std::exclusive_scan(first, last, out, init, op);
+
+        const size_t blocks = detail::BlockCount(pool, n);
+        std::vector<T> carries(blocks, init);
+        pool.ParallelFor(0, blocks, 1, [&](size_t block)
+                         {
+                             if (block + 1 == blocks)
+                                 return;
+                             const size_t begin = detail::BlockBegin(n, blocks, block);
+                             const size_t end = detail::BlockBegin(n, blocks, block + 1);
+                             carries[block + 1] = std::accumulate(first + begin + 1, first + end, T(first[begin]), op); });
+
+        // carries[b] becomes init combined with every block before b.
+        for (size_t block = 1; block < blocks; ++block)
+            carries[block] = op(carries[block - 1], carries[block]);
+
+        pool.ParallelFor(0, blocks, 1, [&](size_t block)
+                         {
+                             const size_t begin = detail::BlockBegin(n, blocks, block);
+                             const size_t end = detail::BlockBegin(n, blocks, block + 1);
+                             std::exclusive_scan(first + begin, first + end, out + begin, carries[block], op); });
+        return out + n;
+    }
+
+    /**
+     * @brief Parallel stable partition: elements satisfying @p pred first, relative order kept.
+     *
+     * The predicate is evaluated once per element while counting; the
+     * elements are then moved out to a scratch buffer and scattered back to
+     * their final positions in parallel. Equivalent to std::stable_partition.
+     *
+     * @return Iterator to the first element of the second group.
+     */
+    template <typename RandomIt, typename Predicate>
+    RandomIt Partition(ThreadPool &pool, RandomIt first, RandomIt last, Predicate pred)
+    {
+        using T = typename std::iterator_traits<RandomIt>::value_type;
+
+        const size_t n = static_cast<size_t>(last - first);
+        if (detail::RunSequential(pool, n))
+            return std::stable_partition(first, last, pred);
+
+        const size_t blocks = detail::BlockCount(pool, n);
+        std::vector<uint8_t> selected(n);
+        std::vector<size_t> before(blocks + 1, 0);
+        pool.ParallelFor(0, blocks, 1, [&](size_t block)
+                         {
+                             const size_t end = detail::BlockBegin(n, blocks, block + 1);
+                             size_t count = 0;
+                             for (size_t i = detail::BlockBegin(n, blocks, block); i < end; ++i)
+                             {
+                                 selected[i] = pred(std::as_const(first[i])) ? 1 : 0;
+                                 count += selected[i];
+                             }
+                             before[block + 1] = count; });
+
+        // before[b] becomes the number of selected elements in blocks [0, b).
+        for (size_t block = 1; block <= blocks; ++block)
+            before[block] += before[block - 1];
+        const size_t selectedCount = before[blocks];
+
+        detail::ScratchBuffer<T> buffer(pool, first, n, blocks);
+        T *scratch = buffer.Data();
+        pool.ParallelFor(0, blocks, 1, [&](size_t block)
+                         {
+                             const size_t begin = detail::BlockBegin(n, blocks, block);
+                             const size_t end = detail::BlockBegin(n, blocks, block + 1);
+                             size_t yes = before[block];
+                             size_t no = selectedCount + (begin - before[block]);
+                             for (size_t i = begin; i < end; ++i)
+                                 first[selected[i] ? yes++ : no++] = std::move(scratch[i]); });
+
+        return first + selectedCount;
+    }
+} // namespace cp::parallel
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <vector>
+#include "cp_framework/core/export.hpp"
+
+namespace cp
+{
+    class ThreadPool;
+
+    /**
+     * @class TaskGraph
+     * @brief Reusable DAG of tasks executed on a ThreadPool.
+     *
+     * Nodes are created once (e.g. at startup) and wired with dependency
+     * edges, continuations (Then), joins (WhenAll) and races (WhenAny).
+     * Run() schedules every root node; each finishing node decrements the
+     * pending-predecessor counters of its successors and dispatches the ones
+     * that become ready. No thread ever blocks on a future.
+     *
+     * The graph can be run again once the previous run completed. Runs only
+     * reset atomic counters, so a frame graph built once costs no allocation
+     * per frame (node callables are stored at build time).
+     *
+     * Typical usage:
+     * @code
+     * TaskGraph frame;
+     * auto animation = frame.Emplace([] { Animate(); });
+     * auto transforms = animation.Then([] { UpdateTransforms(); });
+     * auto culling = transforms.Then([] { Cull(); });
+     * culling.Then([] { RecordCommands(); });
+     *
+     * // every frame
+     * frame.Run(pool);
+     * frame.Wait();
+     * @endcode
+     *
+     * @ingroup Threading
+     */
+    class CP_API TaskGraph
+    {
+    public:
+        /**
+         * @class Node
+         * @brief Lightweight handle to a node of a TaskGraph.
+         */
+        class Node
+        {
+        public:
+            Node() = default;
+
+            /**
+             * @brief Makes this node run before @p successor.
+             * @return This node, for chaining.
+             */
+            Node &Precede(Node successor);
+
+            /**
+             * @brief Makes this node run after @p predecessor.
+             * @return This node, for chaining.
+             */
+            Node &Succeed(Node predecessor);
+
+            /**
+             * @brief Creates a continuation that runs once this node finished.
+             *
+             * @param work Callable executed by the continuation.
+             * @return Handle of the new node.
+             */
+            Node Then(std::function<void()> work);
+
+            /**
+             * @brief Returns whether the handle refers to a node.
+             */
+            bool Valid() const { return m_graph != nullptr; }
+
+        private:
+            friend class TaskGraph;
+
+            Node(TaskGraph *graph, size_t index) : m_graph(graph), m_index(index) {}
+
+            TaskGraph *m_graph = nullptr; ///< Owning graph.
+            size_t m_index = 0;           ///< Index inside the graph.
+        };
+
+        TaskGraph() = default;
+
+        /**
+         * @brief Waits for an in-flight run before destroying the nodes.
+         */
+        ~TaskGraph();
+
+        TaskGraph(const TaskGraph &) = delete;
+        TaskGraph &operator=(const TaskGraph &) = delete;
+
+        /**
+         * @brief Adds a node with no dependencies.
+         *
+         * @param work Callable executed when the node runs.
+         * @return Handle of the new node.
+         */
+        Node Emplace(std::function<void()> work);
+
+        /**
+         * @brief Adds an edge: @p after runs once @p before finished.
+         */
+        void AddDependency(Node before, Node after);
+
+        /**
+         * @brief Adds a node that runs once all of @p nodes finished.
+         */
+        Node WhenAll(std::initializer_list<Node> nodes, std::function<void()> work);
+
+        /**
+         * @brief Adds a node that runs as soon as the first of @p nodes finished.
+         *
+         * The remaining predecessors still run to completion; they just do
+         * not gate this node.
+         */
+        Node WhenAny(std::initializer_list<Node> nodes, std::function<void()> work);
+
+        /**
+         * @brief Schedules all root nodes on @p pool and returns immediately.
+         *
+         * @throws std::logic_error if a previous run is still in flight or the graph has a cycle.
+         * @throws std::runtime_error if @p pool is shut down.
+         */
+        void Run(ThreadPool &pool);
+
+        /**
+         * @brief Waits for the current run to finish, executing pool tasks meanwhile.
+         *
+         * Rethrows the first exception thrown by a node during the run. If a
+         * node could not be dispatched (the pool shut down mid-run), the run
+         * is aborted: nodes not started yet are skipped and a
+         * std::runtime_error is reported unless a node failed first.
+         */
+        void Wait();
+
+        /**
+         * @brief Returns whether no run is in flight.
+         */
+        bool IsComplete() const { return m_outstanding.load(std::memory_order_acquire) == 0; }
+
+        /**
+         * @brief Returns the number of nodes.
+         */
+        size_t Size() const { return m_nodes.size(); }
+
+        /**
+         * @brief Removes every node. The graph must not be running.
+         */
+        void Clear();
+
+    private:
+        /**
+         * @brief Node storage. Lives in a deque so addresses stay stable.
+         */
+        struct NodeData
+        {
+            std::function<void()> work;       ///< Node body.
+            std::vector<size_t> successors;   ///< Nodes gated by this one.
+            size_t predecessorCount = 0;      ///< Number of incoming edges.
+            bool anyOf = false;               ///< WhenAny semantics: first predecessor releases it.
+            std::atomic<size_t> remaining{0}; ///< Predecessors still to finish in the current run.
+        };
+
+        Node AddNode(std::function<void()> work, bool anyOf);
+
+        /**
+         * @brief Verifies that the graph is acyclic (Kahn's algorithm).
+         */
+        void Validate();
+
+        /**
+         * @brief Queues a ready node on the pool, or drops it once the run is aborted.
+         */
+        void Schedule(size_t index);
+
+        /**
+         * @brief Runs a node and releases its successors.
+         */
+        void Execute(size_t index);
+
+        /**
+         * @brief Counts one finished predecessor of a node; returns whether the node became ready.
+         */
+        bool Release(size_t index);
+
+        /**
+         * @brief Aborts the run and retires a node that will never run, along with the successors it gates.
+         */
+        void Drop(size_t index);
+
+        /**
+         * @brief Records @p error as the run's error unless one was recorded first.
+         */
+        void Fail(std::exception_ptr error);
+
+        std::deque<NodeData> m_nodes;         ///< All nodes.
+        ThreadPool *m_pool = nullptr;         ///< Pool used by the current run.
+        std::atomic<size_t> m_outstanding{0}; ///< Nodes not yet finished in the current run.
+        std::atomic_bool m_aborted{false};    ///< A node was dropped: the run starts no more nodes.
+        bool m_validated = false;             ///< Topology checked since the last change.
+
+        std::exception_ptr m_error; ///< First exception thrown by a node.
+        std::mutex m_errorMutex;    ///< Guards m_error.
+    };
+} // namespace cp
@@ -1,16 +1,31 @@
 #pragma once
 
 #include <vector>
-#include <deque>
 #include <thread>
 #include <mutex>
-#include <condition_variable>
 #include <future>
 #include <functional>
+#include <tuple>
 #include <atomic>
-#include <random>
 #include <memory>
+#include <exception>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+#include <string>
+#include <unordered_map>
 #include "cp_framework/core/export.hpp"
+#include "cp_framework/threading/cancellation.hpp"
+#include "cp_framework/threading/eventCount.hpp"
+#include "cp_framework/threading/job.hpp"
+#include "cp_framework/threading/timerWheel.hpp"
+#include "cp_framework/threading/workStealingDeque.hpp"
 
 namespace cp
 {
@@ -18,9 +33,15 @@ namespace cp
      * @enum TaskPriority
      * @brief Defines scheduling priority for tasks submitted to the ThreadPool.
      *
-     * - HIGH   → Task is inserted at the front of the queue.
-     * - NORMAL → Task is appended at the back of the queue.
-     * - LOW    → Behaves like NORMAL (unless custom logic is added).
+     * Each priority has its own lane in every worker queue:
+     * - HIGH   → Served first, and stolen from other workers before any
+     *            lower-priority local work (frame-critical jobs).
+     * - NORMAL → Default lane.
+     * - LOW    → Background work (e.g. asset decoding).
+     *
+     * Lower lanes age: after ThreadPool::kAgingInterval tasks were taken from
+     * higher lanes, a worker gives the next waiting lower lane one turn, so
+     * LOW work cannot starve under a steady stream of HIGH/NORMAL tasks.
      *
      * @ingroup Threading
      */
@@ -31,25 +52,272 @@ namespace cp
         LOW
     };
 
+    /**
+     * @enum WorkerAffinity
+     * @brief How ThreadPool workers are bound to CPUs.
+     *
+     * - None     → Workers float; the OS scheduler places them.
+     * - NumaNode → Each worker may run on any CPU of its NUMA node, so it
+     *              never migrates across sockets but can still be balanced.
+     * - Cpu      → Each worker is pinned to a single CPU.
+     *
+     * @ingroup Threading
+     */
+    enum class WorkerAffinity
+    {
+        None,
+        NumaNode,
+        Cpu
+    };
+
+    /**
+     * @enum WorkerSchedPolicy
+     * @brief OS scheduling class applied to ThreadPool workers.
+     *
+     * On Linux these map to SCHED_BATCH, SCHED_IDLE, SCHED_FIFO and SCHED_RR
+     * (the realtime ones need CAP_SYS_NICE); on Windows to thread priorities.
+     *
+     * @ingroup Threading
+     */
+    enum class WorkerSchedPolicy
+    {
+        Inherit,    ///< Keep the creating thread's policy.
+        Batch,      ///< Throughput work, slightly disfavoured for wakeups.
+        Idle,       ///< Runs only when nothing else wants the CPU.
+        Fifo,       ///< Realtime, first-in first-out.
+        RoundRobin  ///< Realtime, time-sliced.
+    };
+
+    /**
+     * @struct ScheduleRecord
+     * @brief Where one task of a deterministic pool ran (see ScheduleLog).
+     *
+     * @ingroup Threading
+     */
+    struct ScheduleRecord
+    {
+        uint64_t task = 0;   ///< Task id, derived from the seed and the task's place in the submission tree.
+        uint32_t worker = 0; ///< Worker that took the task (and ran or dropped it).
+        uint32_t victim = 0; ///< Worker whose queue it was taken from; equal to @ref worker unless stolen.
+    };
+
+    /**
+     * @struct ScheduleLog
+     * @brief Task-to-worker assignment recorded by a deterministic ThreadPool.
+     *
+     * Obtained from ThreadPool::GetScheduleLog() and fed back through
+     * ThreadPoolConfig::replay to run the same tasks on the same workers.
+     * Write() and Read() store it as plain text, so a schedule captured in
+     * one run can be replayed in another:
+     * @code
+     * // Recording run
+     * std::ofstream out("frame.schedule");
+     * pool.GetScheduleLog().Write(out);
+     *
+     * // Later run
+     * std::ifstream in("frame.schedule");
+     * auto log = std::make_shared<ScheduleLog>(ScheduleLog::Read(in));
+     * ThreadPool replay({.threadCount = log->threadCount, .deterministic = true,
+     *                    .seed = log->seed, .replay = log});
+     * @endcode
+     *
+     * @ingroup Threading
+     */
+    struct CP_API ScheduleLog
+    {
+        uint64_t seed = 0;                   ///< Seed of the pool that recorded the log.
+        size_t threadCount = 0;              ///< Worker count of the pool that recorded the log.
+        std::vector<ScheduleRecord> records; ///< One entry per task taken from a queue, sorted by task id.
+
+        /**
+         * @brief Returns the number of recorded tasks that were stolen.
+         */
+        size_t StealCount() const;
+
+        /**
+         * @brief Writes the log as text: a header line, then one "task worker victim" line per record.
+         */
+        void Write(std::ostream &out) const;
+
+        /**
+         * @brief Parses a log written by Write().
+         *
+         * @throws std::runtime_error if the input is not a schedule log.
+         */
+        static ScheduleLog Read(std::istream &in);
+    };
+
+    /**
+     * @struct ThreadPoolConfig
+     * @brief Construction options for ThreadPool.
+     *
+     * Idle policy: a worker that finds no work first busy-spins (with a CPU
+     * pause hint), then yields its time slice, and only then parks on the
+     * pool's EventCount. Spinning hides the wakeup latency of a futex round
+     * trip for bursty fine-grained work; parking keeps idle pools at 0% CPU.
+     *
+     * Placement: with an affinity other than None, the usable CPUs (@ref cpus,
+     * or every CPU the process may run on) are ordered by NUMA node, the
+     * first @ref reservedCpus are left to the main/render threads, and
+     * workers are assigned to the rest in order, filling one node before
+     * the next. Placement failures (e.g. missing permissions) are logged
+     * and otherwise ignored.
+     *
+     * Elastic sizing: with 0 < @ref minThreadCount < @ref threadCount the pool
+     * starts @ref minThreadCount workers and treats @ref threadCount as the
+     * maximum. While no worker is parked, a worker is added when a
+     * submission leaves a queue deeper than @ref growQueueDepth or a task
+     * waited longer than @ref growLatency before starting. Workers retire
+     * from the highest index down once idle for @ref idleRetireTime, never
+     * below the minimum. Queues, counters and placement exist for the
+     * maximum from the start, so resizing only starts or joins a thread.
+     *
+     * Deterministic mode (@ref deterministic): every task gets an id derived
+     * from @ref seed and its place in the submission tree (the n-th task
+     * submitted from outside the pool, or the n-th child of a given task),
+     * so ids do not depend on timing. Submissions from outside the pool go
+     * to the queue picked by the id instead of the least loaded one, only
+     * workers run queued tasks (waiting non-worker threads yield instead of
+     * helping), elastic sizing is off, and every task taken from a queue is
+     * recorded with its worker and steal victim (GetScheduleLog()). With a
+     * @ref replay log, each recorded task is routed straight to the worker
+     * that ran it and stealing is disabled, so the task-to-worker assignment
+     * repeats exactly; tasks missing from the log fall back to the seeded
+     * queue. Ids, and thus replays, are reproducible as long as tasks are
+     * submitted from outside the pool by a single thread (timer tasks count
+     * as outside submissions) and each task spawns its children in a fixed
+     * order. Recording takes an uncontended lock per task, so the mode is
+     * meant for investigations and benchmarks, not shipping builds.
+     *
+     * @ingroup Threading
+     */
+    struct ThreadPoolConfig
+    {
+        size_t threadCount = std::thread::hardware_concurrency(); ///< Number of worker threads (maximum when elastic).
+        uint32_t spinCount = 256;                                 ///< Work-search attempts with a pause hint before yielding.
+        uint32_t yieldCount = 16;                                 ///< Work-search attempts with a yield before parking.
+
+        WorkerAffinity affinity = WorkerAffinity::None;             ///< CPU binding of the workers.
+        std::vector<uint32_t> cpus;                                 ///< CPUs available to workers (empty = all allowed CPUs).
+        uint32_t reservedCpus = 0;                                  ///< CPUs kept free for non-pool threads (taken from the front).
+        bool numaAwareStealing = true;                              ///< Thieves try workers of their own NUMA node first.
+        std::string threadName = "cp-worker";                       ///< Workers are named "<threadName>-<index>"; empty = unnamed.
+        WorkerSchedPolicy schedPolicy = WorkerSchedPolicy::Inherit; ///< Scheduling class of the workers.
+        int schedPriority = 0;                                      ///< Priority for Fifo/RoundRobin (Linux: 1-99).
+
+        size_t minThreadCount = 0;                            ///< Elastic sizing when nonzero and below threadCount.
+        std::chrono::milliseconds idleRetireTime{5000};       ///< Elastic: idle time after which a worker retires.
+        size_t growQueueDepth = 8;                            ///< Elastic: queue depth that triggers a new worker.
+        std::chrono::microseconds growLatency{2000};          ///< Elastic: queueing delay that triggers a new worker.
+        std::function<void(size_t from, size_t to)> onResize; ///< Elastic: called after each resize, on the resizing thread.
+
+        bool deterministic = false;                ///< Seeded queue selection and schedule recording (disables elastic sizing).
+        uint64_t seed = 0;                         ///< Deterministic: seed of task ids and queue selection.
+        std::shared_ptr<const ScheduleLog> replay; ///< Deterministic: schedule to reproduce; stealing is disabled while running.
+    };
+
+    /**
+     * @struct TaskOptions
+     * @brief Per-task submission options (see ThreadPool::Submit() and ThreadPool::Dispatch()).
+     *
+     * A task whose token was cancelled, or whose deadline passed, by the
+     * time a thread takes it from its queue is dropped without running. Its
+     * callable is destroyed, so a Submit() future reports
+     * std::future_errc::broken_promise. Drops are counted in
+     * WorkerStats::cancelled and WorkerStats::expired.
+     * @code
+     * CancellationSource zone;
+     * pool.Submit({.priority = TaskPriority::LOW,
+     *              .token = zone.Token(),
+     *              .deadline = std::chrono::steady_clock::now() + 500ms},
+     *             [path] { return DecodeTexture(path); });
+     * ...
+     * zone.Cancel(); // player left the zone: queued decodes are skipped
+     * @endcode
+     *
+     * Checks happen only at dequeue; a running task may poll the token itself.
+     *
+     * @ingroup Threading
+     */
+    struct TaskOptions
+    {
+        using Clock = std::chrono::steady_clock;
+
+        TaskPriority priority = TaskPriority::NORMAL;          ///< Scheduling priority.
+        CancellationToken token;                               ///< Drops the task once cancelled.
+        Clock::time_point deadline = Clock::time_point::max(); ///< Drops the task if it has not started by then.
+    };
+
+    /**
+     * @struct WorkerStats
+     * @brief Snapshot of one worker's counters (see ThreadPool::GetStats()).
+     *
+     * @ingroup Threading
+     */
+    struct WorkerStats
+    {
+        uint64_t executed = 0;     ///< Tasks run by the worker, own and stolen; drops are not included.
+        uint64_t stolen = 0;       ///< Tasks taken from other workers' queues.
+        uint64_t failedSteals = 0; ///< Steal attempts (one per lane sweep) that found nothing.
+        uint64_t idleNs = 0;       ///< Time spent searching for work, spinning or parked.
+        uint64_t busyNs = 0;       ///< Uptime minus idle time.
+        size_t queueDepth = 0;     ///< Tasks currently queued on the worker, all lanes.
+        uint64_t cancelled = 0;    ///< Tasks dropped at dequeue because their token was cancelled.
+        uint64_t expired = 0;      ///< Tasks dropped at dequeue because their deadline had passed.
+        bool active = true;        ///< Whether a thread currently serves this slot (see elastic sizing).
+    };
+
+    /**
+     * @struct ThreadPoolStats
+     * @brief Snapshot of the whole pool's counters.
+     *
+     * @ingroup Threading
+     */
+    struct ThreadPoolStats
+    {
+        std::vector<WorkerStats> workers; ///< One entry per worker slot, active or not.
+        WorkerStats total;                ///< Sum over all workers.
+        uint64_t uptimeNs = 0;            ///< Time since the pool started.
+        size_t activeWorkers = 0;         ///< Worker threads currently running.
+        uint64_t spawned = 0;             ///< Workers started by elastic growth.
+        uint64_t retired = 0;             ///< Workers retired after idling.
+
+        /**
+         * @brief Returns the busy fraction of the pool's worker time, in [0, 1].
+         */
+        double Utilization() const
+        {
+            const uint64_t all = total.busyNs + total.idleNs;
+            return all ? static_cast<double>(total.busyNs) / static_cast<double>(all) : 0.0;
+        }
+    };
+
     /**
      * @class ThreadPool
-     * @brief A multithreaded task scheduler with priority queues and work distribution.
+     * @brief A multithreaded work-stealing task scheduler.
      *
      * Features:
-     * - Fixed-size pool of worker threads.
-     * - Fair distribution of tasks across threads (randomized index selection).
-     * - Support for prioritized scheduling (high-priority tasks go to the front).
+     * - Fixed-size or elastic pool of worker threads (see ThreadPoolConfig).
+     * - Lock-free per-worker Chase-Lev deques with work stealing.
+     * - Three priority lanes with aging (HIGH is preferred globally when stealing).
      * - Thread-safe job submission.
+     * - Delayed and periodic tasks (SubmitAfter(), SubmitEvery()).
      * - Graceful shutdown via Shutdown().
      *
-     * Internally, each worker thread has:
-     * - A dedicated task queue,
-     * - A mutex for synchronization,
-     * - A condition variable for sleeping and waking.
+     * Internally, each worker thread has, per priority lane:
+     * - A lock-free WorkStealingDeque. Tasks submitted from the worker itself
+     *   are pushed here; the owner pops LIFO, thieves steal FIFO with a CAS.
+     * - An inbox for tasks submitted from non-worker threads, guarded by a
+     *   short-lived per-worker mutex and drained by the owner or by thieves.
+     *
+     * Idle workers spin, then yield, then park on a pool-wide EventCount
+     * (see ThreadPoolConfig), so any submission can wake a thief regardless
+     * of which queue received it, and submitting costs no lock or syscall
+     * while every worker is busy.
      *
      * @ingroup Threading
      */
-    class ThreadPool
+    class CP_API ThreadPool
     {
     public:
         /**
@@ -60,6 +328,13 @@ namespace cp
          */
         explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
 
+        /**
+         * @brief Constructs a thread pool from a full configuration.
+         *
+         * @param config Thread count and idle policy.
+         */
+        explicit ThreadPool(const ThreadPoolConfig &config);
+
         /**
          * @brief Destructs the thread pool and shuts down all workers.
          *
@@ -75,12 +350,12 @@ namespace cp
         /**
          * @brief Submits a callable task for asynchronous execution.
          *
-         * The task is wrapped into a `std::packaged_task`, stored in one of the
-         * internal task queues (chosen randomly) and executed by a worker thread.
+         * The task is wrapped into a `std::packaged_task` (one allocation for the
+         * future's shared state) and executed by a worker thread. When called
+         * from a worker, the task is pushed onto that worker's own deque;
+         * otherwise it goes into the inbox picked by SelectQueue().
          *
-         * Priority behavior:
-         * - HIGH priority → task is pushed to the front of the queue.
-         * - NORMAL / LOW  → task is appended to the back of the queue.
+         * The task is placed in the lane matching @p priority (see TaskPriority).
          *
          * @tparam Func Callable type.
          * @tparam Args Argument pack to forward to the function.
@@ -91,7 +366,10 @@ namespace cp
          *
          * @return std::future<ReturnType> A future holding the callable’s return value.
          *
-         * @throws std::runtime_error if the pool is no longer running.
+         * @note Inside a pool task, prefer Wait(future) over future.get(): get()
+         *       puts the worker to sleep and can deadlock nested parallelism.
+         *
+         * @throws std::runtime_error if called from outside the pool after Shutdown().
          *
          * @ingroup Threading
          */
@@ -99,32 +377,721 @@ namespace cp
         auto Submit(TaskPriority priority, Func &&f, Args &&...args)
             -> std::future<decltype(f(args...))>;
 
+        /**
+         * @brief Submits a callable task with a cancellation token and/or deadline.
+         *
+         * Same as Submit(TaskPriority, ...), but the task is dropped without
+         * running if @p options' token is cancelled or its deadline passed
+         * before a thread picks it up; the future then reports
+         * std::future_errc::broken_promise (see TaskOptions).
+         *
+         * @param options Priority, token and deadline.
+         * @param f Function/callable to invoke.
+         * @param args Arguments forwarded to the callable.
+         * @return Future holding the callable's result.
+         *
+         * @throws std::runtime_error if called from outside the pool after Shutdown().
+         */
+        template <typename Func, typename... Args>
+        auto Submit(const TaskOptions &options, Func &&f, Args &&...args)
+            -> std::future<decltype(f(args...))>;
+
+        /**
+         * @brief Submits a fire-and-forget task with no future attached.
+         *
+         * The callable and its arguments are stored inline in a Job; when they
+         * fit in Job::kInlineSize bytes the submission performs no heap
+         * allocation at all (queue nodes are recycled by the pool).
+         *
+         * The callable must not throw: there is no future to carry the
+         * exception, so an escaping exception calls std::terminate(). That
+         * holds whichever thread runs the task, including a non-worker
+         * helping from TryRunPendingTask() or WaitUntil(); the exception never
+         * reaches the waiter.
+         *
+         * @param priority Scheduling priority for this task.
+         * @param f Function/callable to invoke.
+         * @param args Arguments forwarded to the callable.
+         *
+         * @throws std::runtime_error if called from outside the pool after Shutdown().
+         */
+        template <typename Func, typename... Args>
+        void Dispatch(TaskPriority priority, Func &&f, Args &&...args);
+
+        /**
+         * @brief Dispatches a fire-and-forget task with a cancellation token and/or deadline.
+         *
+         * Same as Dispatch(TaskPriority, ...), but the task is silently
+         * dropped if it was cancelled or expired before it started (see
+         * TaskOptions).
+         *
+         * @throws std::runtime_error if called from outside the pool after Shutdown().
+         */
+        template <typename Func, typename... Args>
+        void Dispatch(const TaskOptions &options, Func &&f, Args &&...args);
+
+        /**
+         * @brief Submits a task that becomes runnable after @p delay.
+         *
+         * The task waits in a hierarchical timing wheel serviced by a single
+         * timer thread (started on first use), not on a worker; once due it is
+         * pushed into the regular queues with @p priority. Insertion and
+         * expiry are O(1), so thousands of pending timers stay cheap. Timer
+         * resolution is one millisecond; tasks never run early.
+         *
+         * If @p token is cancelled before the task runs, the task is dropped
+         * and the future reports std::future_errc::broken_promise.
+         *
+         * @param delay Minimum time before the task runs.
+         * @param f Callable to invoke.
+         * @param token Optional cancellation token.
+         * @param priority Lane used once the task is due.
+         * @return Future holding the callable's result.
+         *
+         * @throws std::runtime_error if the pool is no longer running.
+         */
+        template <typename Rep, typename Period, typename Func>
+        auto SubmitAfter(std::chrono::duration<Rep, Period> delay, Func &&f,
+                         CancellationToken token = {}, TaskPriority priority = TaskPriority::NORMAL)
+            -> std::future<decltype(f())>;
+
+        /**
+         * @brief Runs a task every @p period until @p token is cancelled or the pool shuts down.
+         *
+         * The first run happens one period from now. Runs are scheduled at a
+         * fixed rate; a run is never started while the previous one is still
+         * executing, and periods missed because a run overran are skipped.
+         * Like Dispatch(), the callable must not throw.
+         *
+         * @param period Interval between runs (at least one timer tick).
+         * @param f Callable to invoke.
+         * @param token Optional cancellation token stopping further runs.
+         * @param priority Lane used for every run.
+         *
+         * @throws std::runtime_error if the pool is no longer running.
+         */
+        template <typename Rep, typename Period, typename Func>
+        void SubmitEvery(std::chrono::duration<Rep, Period> period, Func &&f,
+                         CancellationToken token = {}, TaskPriority priority = TaskPriority::NORMAL);
+
+        /**
+         * @brief Submits many fire-and-forget jobs at once.
+         *
+         * Compared to one Dispatch() per job, a batch from a non-worker thread
+         * is cut into one contiguous chunk per worker queue, every chunk is
+         * linked outside the lock and spliced into its inbox with a single
+         * lock acquisition, and only as many sleeping workers are woken as
+         * the batch can keep busy. From a worker thread the jobs go onto its
+         * own deque, lock-free, and idle workers steal them.
+         *
+         * The jobs are moved out of @p jobs, which is left holding empty jobs.
+         * Jobs must not throw (see Dispatch()).
+         *
+         * @param jobs Jobs to run.
+         * @param priority Scheduling priority of every job.
+         *
+         * @throws std::runtime_error if the pool is no longer running.
+         */
+        void SubmitBatch(std::span<Job> jobs, TaskPriority priority = TaskPriority::NORMAL);
+
+        /**
+         * @brief Submits one fire-and-forget job per index in [first, last), invoking `fn(i)`.
+         *
+         * Batched like SubmitBatch(), with the jobs built directly into queue
+         * nodes (no temporary container). Each job holds its own copy of
+         * @p fn, so keep captures small to stay within Job::kInlineSize.
+         * Unlike ParallelFor(), the call does not wait; for tiny bodies
+         * ParallelFor() with a grain is cheaper than one job per index.
+         *
+         * If copying @p fn throws, the jobs already queued still run.
+         *
+         * @param first First index.
+         * @param last One past the last index.
+         * @param fn Callable invoked as `fn(size_t)`. Must not throw.
+         * @param priority Scheduling priority of every job.
+         *
+         * @throws std::runtime_error if the pool is no longer running.
+         */
+        template <typename Func>
+        void SubmitRange(size_t first, size_t last, Func &&fn, TaskPriority priority = TaskPriority::NORMAL);
+
+        /**
+         * @brief Awaiter returned by Schedule().
+         */
+        class ScheduleAwaiter
+        {
+        public:
+            ScheduleAwaiter(ThreadPool &pool, TaskPriority priority) : m_pool(pool), m_priority(priority) {}
+
+            bool await_ready() const noexcept { return false; }
+
+            /**
+             * @brief Queues the suspended coroutine's resumption as a pool job.
+             *
+             * @throws std::runtime_error if the pool is no longer running
+             *         (the coroutine then resumes with that exception).
+             */
+            void await_suspend(std::coroutine_handle<> handle) const
+            {
+                m_pool.Dispatch(m_priority, [handle]
+                                { handle.resume(); });
+            }
+
+            void await_resume() const noexcept {}
+
+        private:
+            ThreadPool &m_pool;      ///< Pool that resumes the coroutine.
+            TaskPriority m_priority; ///< Lane used for the resumption.
+        };
+
+        /**
+         * @brief Moves the awaiting coroutine onto a worker thread.
+         *
+         * `co_await pool.Schedule()` suspends the coroutine and resumes it as a
+         * regular job of this pool; the resumption is a single allocation-free
+         * Dispatch(). See Task for the coroutine type.
+         *
+         * @param priority Lane used for the resumption.
+         */
+        ScheduleAwaiter Schedule(TaskPriority priority = TaskPriority::NORMAL) { return ScheduleAwaiter(*this, priority); }
+
+        /**
+         * @brief Runs `fn` over the index range [first, last) in parallel.
+         *
+         * The range is split recursively in halves: one half is pushed as a
+         * stealable task, the other is processed by the current thread, until
+         * pieces are no larger than @p grain. Idle workers steal the largest
+         * outstanding pieces, so load balances itself without a fixed chunk
+         * count. The calling thread takes part in the work and runs other
+         * pending tasks while waiting instead of blocking.
+         *
+         * `fn` may either take a single index, `fn(size_t i)`, or a
+         * sub-range, `fn(size_t begin, size_t end)`; the latter lets callers
+         * keep a tight inner loop.
+         *
+         * If any invocation throws, remaining pieces are skipped and the first
+         * exception is rethrown on the calling thread.
+         *
+         * @param first First index.
+         * @param last One past the last index.
+         * @param grain Largest piece processed without splitting further.
+         *              0 picks a grain from the range size and thread count.
+         * @param fn Body to invoke.
+         *
+         * @throws std::runtime_error if the pool is no longer running.
+         */
+        template <typename Func>
+        void ParallelFor(size_t first, size_t last, size_t grain, Func &&fn);
+
+        /**
+         * @brief Reduces the index range [first, last) in parallel.
+         *
+         * The range is cut into grain-sized chunks that are evaluated with
+         * ParallelFor(); each chunk folds its elements starting from
+         * @p identity, then the chunk results are folded in index order on the
+         * calling thread. @p reduce therefore only needs to be associative.
+         *
+         * `map` may either take a single index, `T map(size_t i)`, or a chunk,
+         * `T map(size_t begin, size_t end, T init)`.
+         *
+         * @param first First index.
+         * @param last One past the last index.
+         * @param grain Chunk size (0 = automatic).
+         * @param identity Identity element of @p reduce.
+         * @param map Per-element or per-chunk mapping function.
+         * @param reduce Associative combiner, `T reduce(T, T)`.
+         * @return The reduced value (@p identity for an empty range).
+         */
+        template <typename T, typename MapFunc, typename ReduceFunc>
+        T ParallelReduce(size_t first, size_t last, size_t grain, T identity, MapFunc &&map, ReduceFunc &&reduce);
+
+        /**
+         * @brief Parallel equivalent of std::transform for random-access iterators.
+         *
+         * @param first Start of the input range.
+         * @param last End of the input range.
+         * @param out Start of the output range (must hold `last - first` elements).
+         * @param grain Largest piece processed without splitting (0 = automatic).
+         * @param op Unary operation applied to every element.
+         * @return Iterator one past the last written element.
+         */
+        template <typename InputIt, typename OutputIt, typename UnaryOp>
+        OutputIt ParallelTransform(InputIt first, InputIt last, OutputIt out, size_t grain, UnaryOp &&op);
+
+        /**
+         * @brief Runs one pending task on the calling thread, if any is available.
+         *
+         * Workers look at their own queue first and then steal; other threads
+         * steal from any worker, but only tasks of priority @p lowest or
+         * higher. Useful to make progress while waiting.
+         *
+         * @param lowest Lowest priority a non-worker thread may pick up.
+         * @return True if a task was executed.
+         */
+        bool TryRunPendingTask(TaskPriority lowest = TaskPriority::LOW);
+
+        /**
+         * @brief Runs pending tasks on the calling thread until `done()` returns true.
+         *
+         * This is the building block of every waiting primitive of the pool:
+         * instead of sleeping, a worker keeps executing its own queued tasks
+         * and steals from others, so nested waits cannot starve the pool of
+         * threads and no core idles while work is available.
+         *
+         * A thread outside the pool (e.g. the main thread joining the frame's
+         * jobs) only helps with tasks of priority @p lowest or higher, so it
+         * does not pick up a long LOW task while waiting for NORMAL ones.
+         *
+         * @param done Predicate polled between tasks. Must be cheap and thread-safe.
+         * @param lowest Lowest priority a non-worker thread may pick up while waiting.
+         */
+        template <typename Predicate>
+        void WaitUntil(Predicate &&done, TaskPriority lowest = TaskPriority::LOW);
+
+        /**
+         * @brief Waits for a future to become ready while executing other tasks.
+         *
+         * Safe to call from inside a pool task, including for a future of a
+         * task queued behind the caller on the same worker.
+         *
+         * @param future A std::future or std::shared_future. Not consumed;
+         *               call get() afterwards to obtain the value.
+         */
+        template <typename Future>
+        void Wait(const Future &future);
+
+        /**
+         * @brief Waits for every given future while executing other tasks.
+         */
+        template <typename... Futures>
+        void WaitAll(const Futures &...futures);
+
+        /**
+         * @brief Waits for every future in a vector while executing other tasks.
+         */
+        template <typename Future>
+        void WaitAll(const std::vector<Future> &futures);
+
         /**
          * @brief Signals all workers to stop and waits for them to finish.
          *
-         * After Shutdown() is called, no more tasks can be submitted.
+         * After Shutdown() is called, no more tasks can be submitted from
+         * outside the pool. Every task queued before runs (or is dropped if
+         * cancelled or expired); tasks still running may Submit() or
+         * Dispatch() more, which the workers drain before exiting.
          */
         void Shutdown();
 
+        /**
+         * @brief Returns whether the pool still accepts tasks from outside (Shutdown() not called yet).
+         */
+        bool IsRunning() const { return m_running.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Returns the number of worker threads currently running.
+         */
+        size_t GetThreadCount() const { return m_activeWorkers.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Returns the maximum number of worker threads.
+         */
+        size_t GetMaxThreadCount() const { return m_queues.size(); }
+
+        /**
+         * @brief Takes a snapshot of the per-worker counters.
+         *
+         * Counters are plain relaxed atomics written only by their worker
+         * (no read-modify-write, no shared cache lines), so they stay enabled
+         * in release builds. The snapshot is not atomic across workers.
+         * Callable from any thread, also after Shutdown().
+         */
+        ThreadPoolStats GetStats() const;
+
+        /**
+         * @brief Returns the tasks taken so far and the workers that took them.
+         *
+         * Empty unless ThreadPoolConfig::deterministic is set. Callable from
+         * any thread, also after Shutdown(); call it once the work of interest
+         * has finished for a complete log.
+         */
+        ScheduleLog GetScheduleLog() const;
+
+        /// @brief Number of higher-lane tasks after which a waiting lower lane gets a turn.
+        static constexpr size_t kAgingInterval = 16;
+
     private:
+        /// @brief Number of priority lanes (one per TaskPriority value).
+        static constexpr size_t kLaneCount = 3;
+        struct JobNode;
+
+        /**
+         * @brief Join counter shared by the pieces of one fork-join algorithm.
+         *
+         * Lives on the stack of the waiting caller, which never returns before
+         * `pending` drops to zero.
+         */
+        struct ForkJoin
+        {
+            std::atomic<size_t> pending{0};  ///< Outstanding stolen/queued pieces.
+            std::atomic<bool> failed{false}; ///< Set once a piece threw.
+            std::exception_ptr error;        ///< First captured exception.
+            std::mutex errorMutex;           ///< Guards `error`.
+
+            /// @brief Records the in-flight exception (first one wins).
+            void Fail()
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!failed.load(std::memory_order_relaxed))
+                    error = std::current_exception();
+                failed.store(true, std::memory_order_release);
+            }
+        };
+
+        /**
+         * @brief Splits [begin, end) recursively, queueing the upper halves and running the rest.
+         */
+        template <typename Body>
+        void SplitRange(ForkJoin &join, size_t begin, size_t end, size_t grain, Body &body);
+
+        /**
+         * @brief Returns whether a future is ready without blocking.
+         */
+        template <typename Future>
+        static bool IsReady(const Future &future)
+        {
+            return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+
+        /**
+         * @brief Picks a grain size when the caller passed 0.
+         */
+        size_t AutoGrain(size_t count) const;
+
+        /**
+         * @brief Executes a dequeued node, or drops it if cancelled or expired, and recycles it.
+         *
+         * An exception escaping the job terminates the program (see Dispatch()).
+         */
+        void RunNode(JobNode *node);
+
+        /**
+         * @brief Intrusive FIFO of job nodes, guarded by its owner's inbox mutex.
+         */
+        struct JobList
+        {
+            JobNode *head = nullptr;     ///< Oldest node.
+            JobNode *tail = nullptr;     ///< Newest node.
+            std::atomic<size_t> size{0}; ///< Length, readable without the lock.
+
+            void PushBack(JobNode *node);
+            JobNode *PopFront();
+
+            /// @brief Moves every node of @p other to the back of this list.
+            void Splice(JobList &other);
+        };
+
+        /**
+         * @brief Telemetry of one worker. Written only by the owning worker.
+         */
+        struct WorkerCounters
+        {
+            std::atomic<uint64_t> executed{0};     ///< Tasks run (not dropped).
+            std::atomic<uint64_t> stolen{0};       ///< Tasks taken from other queues.
+            std::atomic<uint64_t> failedSteals{0}; ///< Steal sweeps that found nothing.
+            std::atomic<uint64_t> idleNs{0};       ///< Accumulated idle time of finished idle periods.
+            std::atomic<uint64_t> cancelled{0};    ///< Tasks dropped because their token was cancelled.
+            std::atomic<uint64_t> expired{0};      ///< Tasks dropped because their deadline had passed.
+            std::atomic<int64_t> idleSince{0};     ///< Steady-clock ns at which the current idle period began, 0 while busy.
+
+            /// @brief Single-writer increment: a load and a store, no locked instruction.
+            static void Add(std::atomic<uint64_t> &counter, uint64_t amount = 1)
+            {
+                counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+            }
+        };
+
+        /**
+         * @brief Per-worker task storage, one deque and one inbox per priority lane.
+         */
+        struct WorkerQueue
+        {
+            WorkStealingDeque<JobNode *> deques[kLaneCount]; ///< Lock-free local deques (owner push/pop, thieves steal).
+            std::mutex inboxMutex;                           ///< Guards every inbox lane.
+            JobList inboxes[kLaneCount];                     ///< Tasks submitted from non-worker threads.
+            size_t starvation[kLaneCount] = {};              ///< Higher-lane tasks taken since each lane was served (owner only).
+            alignas(64) WorkerCounters counters;             ///< Telemetry (owner writes, anyone reads).
+
+            std::vector<uint32_t> cpus;  ///< CPUs the worker is bound to (empty = unbound).
+            uint32_t node = 0;           ///< NUMA node the worker is placed on.
+            std::vector<size_t> victims; ///< Steal order: same-node workers first, then the rest.
+
+            std::mutex recordMutex;              ///< Guards records (deterministic pools only).
+            std::vector<ScheduleRecord> records; ///< Tasks taken by this worker (deterministic pools only).
+
+            /**
+             * @brief Approximate number of queued tasks over all lanes.
+             */
+            size_t Depth() const
+            {
+                size_t depth = 0;
+                for (size_t lane = 0; lane < kLaneCount; ++lane)
+                    depth += deques[lane].Size() + inboxes[lane].size.load(std::memory_order_relaxed);
+                return depth;
+            }
+        };
+
+        /// @brief Resolution of the timer wheel.
+        static constexpr std::chrono::milliseconds kTimerTick{1};
+
+        /// @brief Elastic: minimum time between two growth attempts, so a burst does not spawn every slot at once.
+        static constexpr std::chrono::microseconds kGrowCooldown{500};
+
+        /**
+         * @brief A delayed or periodic task filed in the timer wheel.
+         */
+        struct TimerEntry
+        {
+            Job job;                    ///< Task body; invoked once per run.
+            CancellationToken token;    ///< Stops the timer when cancelled.
+            uint64_t period = 0;        ///< Ticks between runs; 0 for one-shot timers.
+            TaskPriority priority{};    ///< Lane used when due.
+            uint64_t deadline = 0;      ///< Due tick (managed by the wheel).
+            TimerEntry *next = nullptr; ///< Wheel slot link.
+        };
+
+        /**
+         * @brief Files a timer due @p delay from now and starts the timer thread if needed.
+         */
+        void AddTimer(std::unique_ptr<TimerEntry> entry, std::chrono::nanoseconds delay);
+
+        /**
+         * @brief Runs a due timer on a worker and re-files it if it is periodic.
+         */
+        void RunTimer(std::unique_ptr<TimerEntry> entry);
+
+        /**
+         * @brief Timer thread: advances the wheel and queues due timers.
+         */
+        void TimerLoop();
+
+        /**
+         * @brief Stops the timer thread and frees every pending timer.
+         */
+        void StopTimers();
+
+        /**
+         * @brief Converts a time point to whole timer ticks since the pool started.
+         */
+        uint64_t TimerTick(std::chrono::steady_clock::time_point time) const;
+
+        /**
+         * @brief Picks the target queue for a submission from a non-worker thread.
+         *
+         * Uses the "power of two choices": one candidate comes from a thread-local
+         * round-robin cursor, the other from a thread-local xorshift generator,
+         * and the shallower queue wins. No shared state is written, so concurrent
+         * producers never contend here.
+         *
+         * @return Index of the selected queue.
+         */
+        size_t SelectQueue() const;
+
+        /**
+         * @brief Deterministic: returns the id of a task being submitted from the calling thread.
+         *
+         * Tasks submitted by a running task are numbered after it, so their ids
+         * do not depend on which worker ran the parent or when.
+         */
+        uint64_t NextTaskId();
+
+        /**
+         * @brief Deterministic: returns the queue a task is placed on, the recorded worker when replaying.
+         */
+        size_t HomeQueue(uint64_t taskId) const;
+
+        /**
+         * @brief Deterministic: appends a taken task to the worker's schedule records.
+         */
+        void RecordTask(size_t index, const JobNode *node, size_t victim);
+
+        /**
+         * @brief Shared body of the Submit() overloads: wraps the call into a packaged_task and enqueues it.
+         */
+        template <typename Func, typename... Args>
+        auto SubmitTask(TaskPriority priority, CancellationToken token, TaskOptions::Clock::time_point deadline,
+                        Func &&f, Args &&...args)
+            -> std::future<decltype(f(args...))>;
+
+        /**
+         * @brief Shared body of the Dispatch() overloads: stores the call in a Job and enqueues it.
+         */
+        template <typename Func, typename... Args>
+        void DispatchTask(TaskPriority priority, CancellationToken token, TaskOptions::Clock::time_point deadline,
+                          Func &&f, Args &&...args);
+
+        /**
+         * @brief Brackets a submission from outside the pool; throws once the pool is shut down.
+         *
+         * Shutdown() clears m_running and then waits for the submissions in
+         * flight, so an external submission either fails or is queued before
+         * any worker may exit. Submissions from the pool's own workers are not
+         * counted: they stay accepted while the workers drain.
+         */
+        struct SubmitScope
+        {
+            explicit SubmitScope(ThreadPool &owner);
+            ~SubmitScope();
+
+            SubmitScope(const SubmitScope &) = delete;
+            SubmitScope &operator=(const SubmitScope &) = delete;
+
+            ThreadPool *pool; ///< Pool being submitted to, nullptr on its own workers.
+        };
+
+        /**
+         * @brief Wraps a job into a pooled node, routes it to a queue and wakes a sleeping worker.
+         *
+         * @param job Job to enqueue.
+         * @param priority Scheduling priority.
+         * @param token Drops the job at dequeue once cancelled.
+         * @param deadline Drops the job at dequeue once passed.
+         *
+         * @throws std::runtime_error if called from outside the pool after Shutdown().
+         */
+        void Enqueue(Job &&job, TaskPriority priority, CancellationToken token = {},
+                     TaskOptions::Clock::time_point deadline = TaskOptions::Clock::time_point::max());
+
+        /// @brief Builds the job at a batch position; type-erased so batches are filled in place.
+        using JobFactory = Job (*)(void *context, size_t index);
+
+        /**
+         * @brief Enqueues @p count jobs produced by @p factory with one lock per target queue.
+         *
+         * @param count Number of jobs.
+         * @param factory Called once per index in [0, count) to build the job.
+         * @param context Opaque pointer forwarded to @p factory.
+         * @param priority Scheduling priority.
+         */
+        void EnqueueBatch(size_t count, JobFactory factory, void *context, TaskPriority priority);
+
+        /**
+         * @brief Finds the next job for a worker.
+         *
+         * Aged lower lanes are served first; otherwise lanes are tried from
+         * HIGH to LOW, each one locally first and then by stealing.
+         *
+         * @param index Worker index.
+         * @return The job, or nullptr if no work was found.
+         */
+        JobNode *FindWork(size_t index);
+
+        /**
+         * @brief Takes a job of one lane from a worker's own deque or inbox.
+         */
+        JobNode *TakeLocal(size_t index, size_t lane);
+
+        /**
+         * @brief Attempts to take a job of one lane from another worker.
+         *
+         * Workers walk their victim list (same NUMA node first, see
+         * PlaceWorkers()); other threads start at a random worker.
+         *
+         * @param index Index of the stealing worker, or GetMaxThreadCount() (or
+         *              larger) when the caller is not a worker of this pool.
+         * @param lane Priority lane to steal from.
+         * @param victim Optional; receives the index of the queue the job came from.
+         * @return The stolen job, or nullptr.
+         */
+        JobNode *Steal(size_t index, size_t lane, size_t *victim = nullptr);
+
+        /**
+         * @brief Attempts to take a job of one lane from a specific victim.
+         */
+        static JobNode *StealFrom(WorkerQueue &victim, size_t lane);
+
+        /**
+         * @brief Steals from the lanes HIGH to @p lowest, HIGH first.
+         */
+        JobNode *StealAny(size_t index, TaskPriority lowest = TaskPriority::LOW);
+
+        /**
+         * @brief Assigns CPUs, NUMA nodes and steal orders to the worker queues.
+         */
+        void PlaceWorkers();
+
+        /**
+         * @brief Applies name, affinity and scheduling policy to the calling worker thread.
+         */
+        void ConfigureWorkerThread(size_t index) const;
+
+        /**
+         * @brief Elastic: starts one more worker if every running one is busy.
+         *
+         * Called when a queue grew past the depth threshold or a task waited
+         * past the latency threshold. Cheap when no growth is possible.
+         */
+        void MaybeGrow();
+
+        /**
+         * @brief Starts the worker for the first inactive slot. Requires m_resizeMutex.
+         *
+         * @return False if every slot is active.
+         */
+        bool SpawnWorker();
+
+        /**
+         * @brief Elastic: retires the calling worker if it is the highest one and idled long enough.
+         *
+         * @param index Worker index.
+         * @param idleSince Steady-clock ns at which the worker's idle period began.
+         * @return True if the worker must exit.
+         */
+        bool TryRetire(size_t index, int64_t idleSince);
+
         /**
          * @brief Main loop executed by each worker thread.
          *
-         * Continuously waits for tasks, processes them, and exits when the pool is shut down.
+         * Runs tasks while any can be found, applies the spin/yield/park idle
+         * policy otherwise, and exits once the pool is shut down and drained.
          *
          * @param index Index of the worker thread and its associated queue.
          */
         void WorkerLoop(size_t index);
 
     private:
-        std::vector<std::deque<std::function<void()>>> m_queues; ///< Per-thread task queues.
-        std::vector<std::mutex> m_mutexes;                       ///< One mutex per queue.
-        std::vector<std::condition_variable> m_conditions;       ///< One condition variable per queue.
-        std::vector<std::thread> m_workers;                      ///< Worker thread handles.
-        std::atomic_bool m_running;                              ///< Indicates whether the pool accepts tasks.
-
-        std::mt19937 m_rng{std::random_device{}()};   ///< RNG for queue selection.
-        std::uniform_int_distribution<size_t> m_dist; ///< Distribution over worker index range.
+        std::vector<std::unique_ptr<WorkerQueue>> m_queues; ///< Per-thread task queues, one per slot up to the maximum.
+        std::vector<std::thread> m_workers;                 ///< Worker thread handles, one per slot.
+        std::atomic_bool m_running;                         ///< Indicates whether the pool accepts tasks.
+        std::atomic_bool m_stopWorkers{false};              ///< Set by Shutdown() once no submission is in flight; drained workers exit.
+        std::atomic<size_t> m_submitting{0};                ///< External submissions inside a SubmitScope.
+        ThreadPoolConfig m_config;                          ///< Construction options.
+        EventCount m_idle;                                  ///< Parking spot for idle workers.
+        std::chrono::steady_clock::time_point m_startTime;  ///< Pool start, for uptime in GetStats() and timer ticks.
+
+        bool m_elastic = false;                    ///< Whether workers are started and retired on demand.
+        size_t m_minWorkers = 0;                   ///< Elastic: workers never retired.
+        std::mutex m_resizeMutex;                  ///< Serializes spawning and joining of worker threads.
+        std::atomic<size_t> m_activeWorkers{0};    ///< Running workers; always the slots [0, m_activeWorkers).
+        std::atomic<int64_t> m_lastGrowNs{0};      ///< Steady-clock ns of the last growth attempt.
+        std::atomic<uint64_t> m_spawnedWorkers{0}; ///< Workers started by growth.
+        std::atomic<uint64_t> m_retiredWorkers{0}; ///< Workers retired after idling.
+        uint64_t m_nextRetireCheck = 0;            ///< Elastic: timer tick at which parked workers are woken to check for retirement.
+
+        bool m_deterministic = false;                          ///< Seeded placement and schedule recording.
+        bool m_replaying = false;                              ///< Deterministic: routing tasks by m_replayRoutes, no live stealing.
+        uint64_t m_rootTaskId = 0;                             ///< Deterministic: parent id of tasks submitted from outside the pool.
+        std::atomic<uint64_t> m_externalTasks{0};              ///< Deterministic: tasks submitted from outside the pool.
+        std::unordered_map<uint64_t, uint32_t> m_replayRoutes; ///< Replay: recorded worker of each task id.
+
+        std::atomic<uint64_t> m_externalCancelled{0}; ///< Cancelled tasks dropped by non-worker threads.
+        std::atomic<uint64_t> m_externalExpired{0};   ///< Expired tasks dropped by non-worker threads.
+
+        std::mutex m_timerMutex;                               ///< Guards the timer wheel and timer thread state.
+        std::condition_variable m_timerCv;                     ///< Wakes the timer thread.
+        std::thread m_timerThread;                             ///< Timer thread, started by the first timer.
+        TimerWheel<TimerEntry> m_timerWheel;                   ///< Pending delayed/periodic tasks.
+        uint64_t m_timerWake = TimerWheel<TimerEntry>::kNever; ///< Tick the timer thread sleeps until.
+        bool m_timersStopped = false;                          ///< Set by Shutdown(); no more timers are filed.
     };
 
     // ---------------- Template Implementation ----------------
@@ -132,36 +1099,288 @@ namespace cp
     /**
      * @brief Template implementation for task submission.
      *
-     * Wraps the callable in a packaged_task, selects a queue randomly,
-     * and inserts the task respecting the provided priority.
+     * Binds the arguments by value into a lambda, wraps it in a packaged_task
+     * and moves that into a Job, which selects the target queue and respects
+     * the provided priority.
      *
      * @see Submit()
      */
     template <typename Func, typename... Args>
     auto ThreadPool::Submit(TaskPriority priority, Func &&f, Args &&...args)
         -> std::future<decltype(f(args...))>
+    {
+        return SubmitTask(priority, {}, TaskOptions::Clock::time_point::max(),
+                          std::forward<Func>(f), std::forward<Args>(args)...);
+    }
+
+    template <typename Func, typename... Args>
+    auto ThreadPool::Submit(const TaskOptions &options, Func &&f, Args &&...args)
+        -> std::future<decltype(f(args...))>
+    {
+        return SubmitTask(options.priority, options.token, options.deadline,
+                          std::forward<Func>(f), std::forward<Args>(args)...);
+    }
+
+    template <typename Func, typename... Args>
+    auto ThreadPool::SubmitTask(TaskPriority priority, CancellationToken token, TaskOptions::Clock::time_point deadline,
+                                Func &&f, Args &&...args)
+        -> std::future<decltype(f(args...))>
     {
         using ReturnType = decltype(f(args...));
 
+        std::packaged_task<ReturnType()> task(
+            [fn = std::forward<Func>(f), ... bound = std::forward<Args>(args)]() mutable -> ReturnType
+            { return std::invoke(fn, bound...); });
+        std::future<ReturnType> future = task.get_future();
+
+        Enqueue(Job([task = std::move(task)]() mutable
+                    { task(); }),
+                priority, std::move(token), deadline);
+        return future;
+    }
+
+    /**
+     * @brief Template implementation for fire-and-forget submission.
+     *
+     * @see Dispatch()
+     */
+    template <typename Func, typename... Args>
+    void ThreadPool::Dispatch(TaskPriority priority, Func &&f, Args &&...args)
+    {
+        DispatchTask(priority, {}, TaskOptions::Clock::time_point::max(),
+                     std::forward<Func>(f), std::forward<Args>(args)...);
+    }
+
+    template <typename Func, typename... Args>
+    void ThreadPool::Dispatch(const TaskOptions &options, Func &&f, Args &&...args)
+    {
+        DispatchTask(options.priority, options.token, options.deadline,
+                     std::forward<Func>(f), std::forward<Args>(args)...);
+    }
+
+    template <typename Func, typename... Args>
+    void ThreadPool::DispatchTask(TaskPriority priority, CancellationToken token, TaskOptions::Clock::time_point deadline,
+                                  Func &&f, Args &&...args)
+    {
+        if constexpr (sizeof...(Args) == 0)
+            Enqueue(Job(std::forward<Func>(f)), priority, std::move(token), deadline);
+        else
+            Enqueue(Job([fn = std::forward<Func>(f), ... bound = std::forward<Args>(args)]() mutable
+                        { std::invoke(fn, bound...); }),
+                    priority, std::move(token), deadline);
+    }
+
+    template <typename Rep, typename Period, typename Func>
+    auto ThreadPool::SubmitAfter(std::chrono::duration<Rep, Period> delay, Func &&f,
+                                 CancellationToken token, TaskPriority priority)
+        -> std::future<decltype(f())>
+    {
+        using ReturnType = decltype(f());
+
         if (!m_running.load(std::memory_order_acquire))
             throw std::runtime_error("ThreadPool is shut down");
 
-        auto task = std::make_shared<std::packaged_task<ReturnType()>>(
-            std::bind(std::forward<Func>(f), std::forward<Args>(args)...));
-        std::future<ReturnType> future = task->get_future();
+        std::packaged_task<ReturnType()> task(std::forward<Func>(f));
+        std::future<ReturnType> future = task.get_future();
+
+        auto entry = std::make_unique<TimerEntry>();
+        entry->job = Job([task = std::move(task)]() mutable
+                         { task(); });
+        entry->token = std::move(token);
+        entry->priority = priority;
+        AddTimer(std::move(entry), std::chrono::duration_cast<std::chrono::nanoseconds>(delay));
+        return future;
+    }
 
-        size_t idx = m_dist(m_rng);
+    template <typename Rep, typename Period, typename Func>
+    void ThreadPool::SubmitEvery(std::chrono::duration<Rep, Period> period, Func &&f,
+                                 CancellationToken token, TaskPriority priority)
+    {
+        if (!m_running.load(std::memory_order_acquire))
+            throw std::runtime_error("ThreadPool is shut down");
+
+        const auto interval = std::chrono::duration_cast<std::chrono::nanoseconds>(period);
+        const auto ticks = std::chrono::ceil<std::chrono::milliseconds>(interval) / kTimerTick;
+
+        auto entry = std::make_unique<TimerEntry>();
+        entry->job = Job(std::forward<Func>(f));
+        entry->token = std::move(token);
+        entry->period = static_cast<uint64_t>(std::max<int64_t>(1, ticks));
+        entry->priority = priority;
+        AddTimer(std::move(entry), interval);
+    }
+
+    template <typename Func>
+    void ThreadPool::SubmitRange(size_t first, size_t last, Func &&fn, TaskPriority priority)
+    {
+        if (!m_running.load(std::memory_order_acquire))
+            throw std::runtime_error("ThreadPool is shut down");
+        if (first >= last)
+            return;
+
+        using Fn = std::decay_t<Func>;
+        struct Context
         {
-            std::lock_guard<std::mutex> lock(m_mutexes[idx]);
-            if (priority == TaskPriority::HIGH)
-                m_queues[idx].emplace_front([task]
-                                            { (*task)(); });
-            else
-                m_queues[idx].emplace_back([task]
-                                           { (*task)(); });
+            const Fn *fn;
+            size_t first;
+        };
+
+        const Fn &callable = fn;
+        Context context{&callable, first};
+        EnqueueBatch(
+            last - first,
+            [](void *ctx, size_t index) -> Job
+            {
+                const Context &range = *static_cast<Context *>(ctx);
+                return Job([fn = *range.fn, i = range.first + index]() mutable
+                           { fn(i); });
+            },
+            &context, priority);
+    }
+
+    template <typename Body>
+    void ThreadPool::SplitRange(ForkJoin &join, size_t begin, size_t end, size_t grain, Body &body)
+    {
+        while (end - begin > grain)
+        {
+            const size_t mid = begin + (end - begin) / 2;
+            join.pending.fetch_add(1, std::memory_order_relaxed);
+            try
+            {
+                Enqueue(Job([this, &join, mid, end, grain, &body]
+                            {
+                                SplitRange(join, mid, end, grain, body);
+                                join.pending.fetch_sub(1, std::memory_order_release); }),
+                        TaskPriority::NORMAL);
+            }
+            catch (...)
+            {
+                // The pool shut down meanwhile: the rest of the range runs here.
+                join.pending.fetch_sub(1, std::memory_order_relaxed);
+                break;
+            }
+            end = mid;
         }
 
-        m_conditions[idx].notify_one();
-        return future;
+        if (join.failed.load(std::memory_order_relaxed))
+            return;
+
+        try
+        {
+            body(begin, end);
+        }
+        catch (...)
+        {
+            join.Fail();
+        }
+    }
+
+    template <typename Predicate>
+    void ThreadPool::WaitUntil(Predicate &&done, TaskPriority lowest)
+    {
+        while (!done())
+        {
+            if (!TryRunPendingTask(lowest))
+                std::this_thread::yield();
+        }
+    }
+
+    template <typename Future>
+    void ThreadPool::Wait(const Future &future)
+    {
+        WaitUntil([&future]
+                  { return IsReady(future); });
+    }
+
+    template <typename... Futures>
+    void ThreadPool::WaitAll(const Futures &...futures)
+    {
+        (Wait(futures), ...);
+    }
+
+    template <typename Future>
+    void ThreadPool::WaitAll(const std::vector<Future> &futures)
+    {
+        for (const Future &future : futures)
+            Wait(future);
+    }
+
+    template <typename Func>
+    void ThreadPool::ParallelFor(size_t first, size_t last, size_t grain, Func &&fn)
+    {
+        if (!m_running.load(std::memory_order_acquire))
+            throw std::runtime_error("ThreadPool is shut down");
+        if (first >= last)
+            return;
+
+        if (grain == 0)
+            grain = AutoGrain(last - first);
+
+        auto body = [&fn](size_t begin, size_t end)
+        {
+            if constexpr (std::is_invocable_v<Func &, size_t, size_t>)
+                fn(begin, end);
+            else
+                for (size_t i = begin; i < end; ++i)
+                    fn(i);
+        };
+
+        ForkJoin join;
+        SplitRange(join, first, last, grain, body);
+        WaitUntil([&join]
+                  { return join.pending.load(std::memory_order_acquire) == 0; },
+                  TaskPriority::NORMAL);
+
+        if (join.error)
+            std::rethrow_exception(join.error);
+    }
+
+    template <typename T, typename MapFunc, typename ReduceFunc>
+    T ThreadPool::ParallelReduce(size_t first, size_t last, size_t grain, T identity, MapFunc &&map, ReduceFunc &&reduce)
+    {
+        if (first >= last)
+            return identity;
+
+        if (grain == 0)
+            grain = AutoGrain(last - first);
+
+        const size_t chunkCount = (last - first + grain - 1) / grain;
+        std::vector<T> partials(chunkCount, identity);
+
+        ParallelFor(0, chunkCount, 1, [&](size_t chunk)
+                    {
+                        const size_t begin = first + chunk * grain;
+                        const size_t end = std::min(begin + grain, last);
+
+                        if constexpr (std::is_invocable_v<MapFunc &, size_t, size_t, T>)
+                            partials[chunk] = map(begin, end, identity);
+                        else
+                        {
+                            T acc = identity;
+                            for (size_t i = begin; i < end; ++i)
+                                acc = reduce(std::move(acc), map(i));
+                            partials[chunk] = std::move(acc);
+                        } });
+
+        T result = std::move(identity);
+        for (T &partial : partials)
+            result = reduce(std::move(result), std::move(partial));
+        return result;
+    }
+
+    template <typename InputIt, typename OutputIt, typename UnaryOp>
+    OutputIt ThreadPool::ParallelTransform(InputIt first, InputIt last, OutputIt out, size_t grain, UnaryOp &&op)
+    {
+        static_assert(std::is_base_of_v<std::random_access_iterator_tag,
+                                        typename std::iterator_traits<InputIt>::iterator_category>,
+                      "ParallelTransform requires random-access iterators");
+
+        const auto count = static_cast<size_t>(std::distance(first, last));
+        ParallelFor(0, count, grain, [&](size_t begin, size_t end)
+                    {
+                        using Diff = typename std::iterator_traits<InputIt>::difference_type;
+                        for (size_t i = begin; i < end; ++i)
+                            out[static_cast<Diff>(i)] = op(first[static_cast<Diff>(i)]); });
+        return out + static_cast<typename std::iterator_traits<InputIt>::difference_type>(count);
     }
 }
\ No newline at end of file
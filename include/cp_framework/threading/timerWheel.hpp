@@ -0,0 +1,209 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace cp
+{
+    /**
+     * @class TimerWheel
+     * @brief Hierarchical timing wheel (Varghese & Lauck) over intrusive timers.
+     *
+     * Time is measured in integer ticks. Four levels of 64 slots cover
+     * 64, 64², 64³ and 64⁴ ticks ahead (about 4.6 hours at 1 ms per tick);
+     * farther deadlines are parked in the last level and re-filed when
+     * reached. Inserting a timer is O(1). Advancing is O(1) per expired
+     * timer plus one re-filing per level a timer moves down. Occupancy
+     * bitmaps let Advance() and NextEventTick() skip empty stretches
+     * instead of walking every tick.
+     *
+     * The wheel is not thread-safe and owns nothing: callers keep the
+     * timers alive while they are filed and get them back on expiry.
+     *
+     * @tparam Timer Node type with a `Timer *next` link and a
+     *               `uint64_t deadline` tick, both managed by the wheel.
+     *
+     * @ingroup Threading
+     */
+    template <typename Timer>
+    class TimerWheel
+    {
+        static constexpr uint32_t kLevelBits = 6;
+        static constexpr uint32_t kSlotCount = 1u << kLevelBits;
+        static constexpr uint32_t kLevelCount = 4;
+        static constexpr uint64_t kMaxDelta = (uint64_t(1) << (kLevelBits * kLevelCount)) - 1;
+
+    public:
+        /// @brief Returned by NextEventTick() when no timer is filed.
+        static constexpr uint64_t kNever = std::numeric_limits<uint64_t>::max();
+
+        /**
+         * @brief Constructs an empty wheel whose clock reads @p now.
+         */
+        explicit TimerWheel(uint64_t now = 0) : m_now(now) {}
+
+        TimerWheel(const TimerWheel &) = delete;
+        TimerWheel &operator=(const TimerWheel &) = delete;
+
+        /**
+         * @brief Returns the last tick processed by Advance().
+         */
+        uint64_t Now() const { return m_now; }
+
+        /**
+         * @brief Returns whether no timer is filed.
+         */
+        bool Empty() const { return m_count == 0; }
+
+        /**
+         * @brief Returns the number of filed timers.
+         */
+        size_t Size() const { return m_count; }
+
+        /**
+         * @brief Files a timer. Deadlines not after Now() fire on the next tick.
+         */
+        void Insert(Timer *timer)
+        {
+            if (timer->deadline <= m_now)
+                timer->deadline = m_now + 1;
+            File(timer);
+            ++m_count;
+        }
+
+        /**
+         * @brief Returns the earliest tick at which Advance() has something to do.
+         *
+         * That is either a timer expiring or a higher-level slot being
+         * re-filed, so it never lies after the next expiry.
+         */
+        uint64_t NextEventTick() const
+        {
+            uint64_t next = kNever;
+            for (uint32_t level = 0; level < kLevelCount; ++level)
+            {
+                if (m_occupied[level] == 0)
+                    continue;
+
+                const uint32_t shift = level * kLevelBits;
+                const uint64_t block = (m_now >> shift) + 1;
+                const uint32_t offset = static_cast<uint32_t>(
+                    std::countr_zero(std::rotr(m_occupied[level], static_cast<int>(block & (kSlotCount - 1)))));
+                const uint64_t tick = (block + offset) << shift;
+                if (tick < next)
+                    next = tick;
+            }
+            return next;
+        }
+
+        /**
+         * @brief Moves the clock to @p now, handing every expired timer to @p onExpired.
+         *
+         * @param now Target tick. Ignored if not after Now().
+         * @param onExpired Callable invoked as `onExpired(Timer *)`; the timer
+         *                  is unlinked and may be re-inserted from the callback.
+         */
+        template <typename Callback>
+        void Advance(uint64_t now, Callback &&onExpired)
+        {
+            while (m_now < now)
+            {
+                const uint64_t next = NextEventTick();
+                if (next > now)
+                {
+                    m_now = now;
+                    break;
+                }
+
+                m_now = next;
+
+                // Re-file the slots whose range starts at this tick, lowest level first.
+                for (uint32_t level = 1; level < kLevelCount; ++level)
+                {
+                    const uint32_t shift = level * kLevelBits;
+                    if ((m_now & ((uint64_t(1) << shift) - 1)) != 0)
+                        break;
+
+                    Timer *timer = TakeSlot(level, static_cast<uint32_t>((m_now >> shift) & (kSlotCount - 1)));
+                    while (timer)
+                    {
+                        Timer *nextTimer = timer->next;
+                        File(timer);
+                        timer = nextTimer;
+                    }
+                }
+
+                Timer *timer = TakeSlot(0, static_cast<uint32_t>(m_now & (kSlotCount - 1)));
+                while (timer)
+                {
+                    Timer *nextTimer = timer->next;
+                    timer->next = nullptr;
+                    --m_count;
+                    onExpired(timer);
+                    timer = nextTimer;
+                }
+            }
+        }
+
+        /**
+         * @brief Unlinks every filed timer, handing each one to @p onRemoved.
+         */
+        template <typename Callback>
+        void Clear(Callback &&onRemoved)
+        {
+            for (uint32_t level = 0; level < kLevelCount; ++level)
+            {
+                for (uint32_t slot = 0; slot < kSlotCount; ++slot)
+                {
+                    Timer *timer = TakeSlot(level, slot);
+                    while (timer)
+                    {
+                        Timer *nextTimer = timer->next;
+                        timer->next = nullptr;
+                        onRemoved(timer);
+                        timer = nextTimer;
+                    }
+                }
+            }
+            m_count = 0;
+        }
+
+    private:
+        /**
+         * @brief Links a timer into the slot matching its distance from Now().
+         *
+         * Called with deadline >= Now(); a deadline equal to Now() only
+         * happens while re-filing and lands in the slot being expired.
+         */
+        void File(Timer *timer)
+        {
+            const uint64_t delta = timer->deadline - m_now;
+
+            uint32_t level = 0;
+            while (level + 1 < kLevelCount && delta >= (uint64_t(1) << ((level + 1) * kLevelBits)))
+                ++level;
+
+            const uint64_t target = m_now + (delta > kMaxDelta ? kMaxDelta : delta);
+            const uint32_t slot = static_cast<uint32_t>((target >> (level * kLevelBits)) & (kSlotCount - 1));
+
+            timer->next = m_slots[level][slot];
+            m_slots[level][slot] = timer;
+            m_occupied[level] |= uint64_t(1) << slot;
+        }
+
+        Timer *TakeSlot(uint32_t level, uint32_t slot)
+        {
+            Timer *head = m_slots[level][slot];
+            m_slots[level][slot] = nullptr;
+            m_occupied[level] &= ~(uint64_t(1) << slot);
+            return head;
+        }
+
+        Timer *m_slots[kLevelCount][kSlotCount] = {}; ///< Singly linked timer lists.
+        uint64_t m_occupied[kLevelCount] = {};        ///< Bit per non-empty slot.
+        uint64_t m_now = 0;                           ///< Last processed tick.
+        size_t m_count = 0;                           ///< Filed timers.
+    };
+} // namespace cp
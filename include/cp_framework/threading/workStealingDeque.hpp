@@ -0,0 +1,183 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace cp
+{
+    /**
+     * @class WorkStealingDeque
+     * @brief Lock-free Chase-Lev work-stealing deque.
+     *
+     * A single owner thread pushes and pops items at the bottom end without
+     * contending with anyone but a thief racing for the very last item. Any
+     * number of thief threads steal from the top end using a single CAS.
+     *
+     * Implementation follows "Correct and Efficient Work-Stealing for Weak
+     * Memory Models" (Lê, Pop, Cohen, Zappa Nardelli, PPoPP 2013). The ring
+     * buffer grows on demand; retired buffers are kept alive until the deque
+     * is destroyed because a slow thief may still be reading from them.
+     *
+     * @tparam T Element type. Must be trivially copyable (typically a pointer),
+     *           since thieves read slots speculatively before claiming them.
+     *
+     * @ingroup Threading
+     */
+    template <typename T>
+    class WorkStealingDeque
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque requires a trivially copyable element type");
+
+    public:
+        /**
+         * @brief Constructs an empty deque.
+         *
+         * @param capacity Initial ring capacity. Rounded up to a power of two.
+         */
+        explicit WorkStealingDeque(size_t capacity = 1024)
+        {
+            size_t cap = 1;
+            while (cap < capacity)
+                cap <<= 1;
+
+            m_buffers.emplace_back(std::make_unique<Buffer>(cap));
+            m_buffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+        }
+
+        WorkStealingDeque(const WorkStealingDeque &) = delete;
+        WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+        /**
+         * @brief Pushes an item at the bottom. Owner thread only.
+         */
+        void Push(T item)
+        {
+            const int64_t b = m_bottom.load(std::memory_order_relaxed);
+            const int64_t t = m_top.load(std::memory_order_acquire);
+            Buffer *buffer = m_buffer.load(std::memory_order_relaxed);
+
+            if (b - t > static_cast<int64_t>(buffer->capacity) - 1)
+                buffer = Grow(buffer, t, b);
+
+            buffer->Put(b, item);
+            m_bottom.store(b + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Pops the most recently pushed item. Owner thread only.
+         *
+         * @return The item, or std::nullopt if the deque is empty or a thief
+         *         won the race for the last item.
+         */
+        std::optional<T> Pop()
+        {
+            const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+            Buffer *buffer = m_buffer.load(std::memory_order_relaxed);
+            m_bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = m_top.load(std::memory_order_relaxed);
+
+            if (t > b)
+            {
+                // Empty: restore bottom.
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+
+            T item = buffer->Get(b);
+            if (t != b)
+                return item;
+
+            // Last item: race against thieves.
+            const bool won = m_top.compare_exchange_strong(t, t + 1,
+                                                           std::memory_order_seq_cst,
+                                                           std::memory_order_relaxed);
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            if (!won)
+                return std::nullopt;
+            return item;
+        }
+
+        /**
+         * @brief Steals the oldest item from the top. Safe from any thread.
+         *
+         * @return The item, or std::nullopt if the deque was empty or another
+         *         thread claimed the item first.
+         */
+        std::optional<T> Steal()
+        {
+            int64_t t = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t b = m_bottom.load(std::memory_order_acquire);
+
+            if (t >= b)
+                return std::nullopt;
+
+            Buffer *buffer = m_buffer.load(std::memory_order_acquire);
+            T item = buffer->Get(t);
+            if (!m_top.compare_exchange_strong(t, t + 1,
+                                               std::memory_order_seq_cst,
+                                               std::memory_order_relaxed))
+                return std::nullopt;
+            return item;
+        }
+
+        /**
+         * @brief Returns an approximate number of queued items.
+         *
+         * The value may be stale by the time it is observed; use it only
+         * for heuristics and diagnostics.
+         */
+        size_t Size() const
+        {
+            const int64_t b = m_bottom.load(std::memory_order_relaxed);
+            const int64_t t = m_top.load(std::memory_order_relaxed);
+            return b > t ? static_cast<size_t>(b - t) : 0;
+        }
+
+        /**
+         * @brief Returns whether the deque appears empty.
+         */
+        bool Empty() const { return Size() == 0; }
+
+    private:
+        /**
+         * @brief Power-of-two ring of atomically accessed slots.
+         */
+        struct Buffer
+        {
+            explicit Buffer(size_t cap)
+                : capacity(cap), mask(cap - 1), slots(new std::atomic<T>[cap]) {}
+
+            T Get(int64_t i) const { return slots[static_cast<size_t>(i) & mask].load(std::memory_order_relaxed); }
+            void Put(int64_t i, T item) { slots[static_cast<size_t>(i) & mask].store(item, std::memory_order_relaxed); }
+
+            size_t capacity;
+            size_t mask;
+            std::unique_ptr<std::atomic<T>[]> slots;
+        };
+
+        /**
+         * @brief Doubles the ring capacity, copying the live range [t, b).
+         */
+        Buffer *Grow(Buffer *old, int64_t t, int64_t b)
+        {
+            m_buffers.emplace_back(std::make_unique<Buffer>(old->capacity * 2));
+            Buffer *grown = m_buffers.back().get();
+            for (int64_t i = t; i < b; ++i)
+                grown->Put(i, old->Get(i));
+
+            m_buffer.store(grown, std::memory_order_release);
+            return grown;
+        }
+
+        alignas(64) std::atomic<int64_t> m_top{0};    ///< Steal end (thieves).
+        alignas(64) std::atomic<int64_t> m_bottom{0}; ///< Push/pop end (owner).
+        alignas(64) std::atomic<Buffer *> m_buffer{nullptr};
+        std::vector<std::unique_ptr<Buffer>> m_buffers; ///< Current and retired buffers (owner only).
+    };
+} // namespace cp
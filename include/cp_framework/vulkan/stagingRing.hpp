@@ -8,8 +8,15 @@
 #include <thread>
 #include <atomic>
 #include <condition_variable>
+#include <coroutine>
+#include <functional>
 #include <queue>
 
+namespace cp
+{
+    class ThreadPool;
+}
+
 namespace cp::vulkan
 {
     /**
@@ -65,8 +72,9 @@ namespace cp::vulkan
          */
         struct Pending
         {
-            UploadHandle handle;    ///< The upload operation to track.
-            VkDeviceSize offsetEnd; ///< End offset of the reserved region.
+            UploadHandle handle;              ///< The upload operation to track.
+            VkDeviceSize offsetEnd;           ///< End offset of the reserved region.
+            std::function<void()> onComplete; ///< Invoked once the transfer finished.
         };
 
     public:
@@ -156,8 +164,57 @@ namespace cp::vulkan
          * @param handle The asynchronous upload to track.
          * @param offset Start offset of the uploaded region.
          * @param size Size of the uploaded region.
+         * @param onComplete Optional callback invoked on the janitor thread once
+         *                   the transfer finished (immediately for an invalid handle).
+         *                   Must be short and must not throw.
+         */
+        void SubmitAndTrack(UploadHandle handle, VkDeviceSize offset, VkDeviceSize size,
+                            std::function<void()> onComplete = {});
+
+        /**
+         * @brief Awaiter returned by WhenUploaded().
+         */
+        class UploadAwaiter
+        {
+        public:
+            UploadAwaiter(StagingRing &ring, UploadHandle handle, VkDeviceSize offset, VkDeviceSize size, ThreadPool *resumeOn)
+                : m_ring(ring), m_handle(handle), m_offset(offset), m_size(size), m_resumeOn(resumeOn) {}
+
+            bool await_ready() const noexcept { return !m_handle.valid(); }
+
+            void await_suspend(std::coroutine_handle<> awaiting);
+
+            void await_resume() const noexcept {}
+
+        private:
+            StagingRing &m_ring;    ///< Ring tracking the upload.
+            UploadHandle m_handle;  ///< Upload to wait for.
+            VkDeviceSize m_offset;  ///< Start offset of the uploaded region.
+            VkDeviceSize m_size;    ///< Size of the uploaded region.
+            ThreadPool *m_resumeOn; ///< Pool that resumes the coroutine, or nullptr.
+        };
+
+        /**
+         * @brief Tracks an upload and suspends the awaiting coroutine until the GPU finished it.
+         *
+         * Same as SubmitAndTrack(), but for coroutines:
+         * @code
+         * co_await ring.WhenUploaded(handle, reservation.offset, size, &pool);
+         * @endcode
+         * No thread blocks on behalf of the coroutine; the janitor thread that
+         * already waits on the fence triggers the resumption.
+         *
+         * @param handle The asynchronous upload to track.
+         * @param offset Start offset of the uploaded region.
+         * @param size Size of the uploaded region.
+         * @param resumeOn Pool on which the coroutine continues. With nullptr it
+         *                 continues on the janitor thread, which then cannot
+         *                 retire other uploads until the coroutine suspends again.
          */
-        void SubmitAndTrack(UploadHandle handle, VkDeviceSize offset, VkDeviceSize size);
+        UploadAwaiter WhenUploaded(UploadHandle handle, VkDeviceSize offset, VkDeviceSize size, ThreadPool *resumeOn = nullptr)
+        {
+            return UploadAwaiter(*this, handle, offset, size, resumeOn);
+        }
 
     private:
         /**
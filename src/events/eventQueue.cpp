@@ -0,0 +1,252 @@
+#include "cp_framework/events/eventQueue.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace cp
+{
+    EventQueue::EventQueue(size_t capacity)
+        : m_capacity(std::bit_ceil(std::max(capacity, kRecordAlign * 4))),
+          m_mask(m_capacity - 1)
+    {
+        static_assert(sizeof(Record) == kRecordAlign, "a padding record must fit in any gap");
+        m_ring = static_cast<std::byte *>(::operator new(m_capacity, std::align_val_t(64)));
+        std::memset(m_ring, 0, m_capacity);
+    }
+
+    EventQueue::~EventQueue()
+    {
+        for (; m_batchNext < m_batch.size(); ++m_batchNext)
+            Dispatch(nullptr, m_batch[m_batchNext]);
+
+        const uint64_t head = m_head.load(std::memory_order_acquire);
+        while (m_read != head)
+        {
+            Record *record = RecordAt(m_read);
+            if ((std::atomic_ref<uint32_t>(record->state).load(std::memory_order_acquire) & kStateMask) == kReady)
+                record->handler(nullptr, record + 1);
+            m_read += record->size;
+        }
+
+        for (Overflow &entry : m_overflow)
+        {
+            entry.handler(nullptr, entry.payload);
+            ::operator delete(entry.payload, std::align_val_t(entry.alignment));
+        }
+
+        ::operator delete(m_ring, std::align_val_t(64));
+    }
+
+    EventQueue::Record *EventQueue::Reserve(size_t size, Handler handler)
+    {
+        // Large events would leave too little room for everything else.
+        if (size > m_capacity / 4 || m_overflowing.load(std::memory_order_acquire))
+            return nullptr;
+
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        size_t offset, padding;
+        while (true)
+        {
+            offset = head & m_mask;
+            padding = offset + size > m_capacity ? m_capacity - offset : 0;
+
+            // Acquire pairs with ReleaseDispatched(): the consumer is done with the space we reuse.
+            if (head + padding + size - m_tail.load(std::memory_order_acquire) > m_capacity)
+                return nullptr;
+            if (m_head.compare_exchange_weak(head, head + padding + size, std::memory_order_relaxed))
+                break;
+        }
+
+        if (padding)
+        {
+            Record *skip = reinterpret_cast<Record *>(m_ring + offset);
+            skip->size = static_cast<uint32_t>(padding);
+            skip->handler = nullptr;
+            Commit(skip, kSkip);
+            offset = 0;
+        }
+
+        Record *record = reinterpret_cast<Record *>(m_ring + offset);
+        record->size = static_cast<uint32_t>(size);
+        record->handler = handler;
+        return record;
+    }
+
+    void EventQueue::PushOverflow(Overflow &&entry)
+    {
+        std::lock_guard lock(m_overflowMutex);
+        try
+        {
+            m_overflow.push_back(std::move(entry));
+        }
+        catch (...)
+        {
+            entry.handler(nullptr, entry.payload);
+            ::operator delete(entry.payload, std::align_val_t(entry.alignment));
+            throw;
+        }
+        m_overflowing.store(true, std::memory_order_release);
+    }
+
+    size_t EventQueue::Consume(void *context, std::chrono::nanoseconds budget)
+    {
+        const bool timed = budget != std::chrono::nanoseconds::max();
+        const auto start = timed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
+        // Overflowed events come after every ring record reserved before them;
+        // reading both limits under the lock keeps that order in the snapshot.
+        uint64_t end;
+        size_t overflowEnd = 0;
+        if (m_overflowing.load(std::memory_order_acquire))
+        {
+            std::lock_guard lock(m_overflowMutex);
+            end = m_head.load(std::memory_order_acquire);
+            overflowEnd = m_overflow.size();
+        }
+        else
+        {
+            end = m_head.load(std::memory_order_acquire);
+        }
+
+        // Also releases what a throwing listener left dispatched.
+        struct Release
+        {
+            EventQueue &queue;
+            ~Release() { queue.ReleaseDispatched(); }
+        } release{*this};
+
+        size_t dispatched = 0;
+        bool swapped = false;
+        while (true)
+        {
+            // Finish the batch a budget cut short before swapping out a new one.
+            if (m_batchNext == m_batch.size())
+            {
+                if (swapped || !SwapOut(end, overflowEnd))
+                    break;
+                swapped = true;
+            }
+
+            ++dispatched;
+            Dispatch(context, m_batch[m_batchNext++]);
+            // Hand space back as soon as possible so producers need not overflow meanwhile.
+            ReleaseDispatched();
+
+            if (timed && std::chrono::steady_clock::now() - start >= budget)
+                break;
+        }
+        return dispatched;
+    }
+
+    bool EventQueue::SwapOut(uint64_t end, size_t overflowEnd)
+    {
+        m_batch.clear();
+        m_batchNext = 0;
+        m_swapped.clear();
+
+        while (m_scan != end)
+        {
+            Record *record = RecordAt(m_scan);
+            const uint32_t state = std::atomic_ref<uint32_t>(record->state).load(std::memory_order_acquire);
+            if (state == kEmpty)
+                break;
+            if ((state & kStateMask) == kReady)
+                m_swapped.push_back(Pending{record->handler, record + 1, record, 0, 0, state >> kStateBits});
+            m_scan += record->size;
+        }
+
+        // A record still being written holds back the overflow list, which is newer.
+        if (overflowEnd && m_scan == end)
+        {
+            std::lock_guard lock(m_overflowMutex);
+            for (size_t i = 0; i < overflowEnd; ++i)
+                m_swapped.push_back(Pending{m_overflow[i].handler, m_overflow[i].payload, nullptr,
+                                            m_overflow[i].alignment, 0, m_overflow[i].type});
+            m_overflow.erase(m_overflow.begin(), m_overflow.begin() + overflowEnd);
+            if (m_overflow.empty())
+                m_overflowing.store(false, std::memory_order_release);
+        }
+
+        if (m_swapped.empty())
+            return false;
+
+        // Stable counting sort by type, types ordered by first appearance.
+        m_groups.clear();
+        size_t last = 0;
+        for (Pending &entry : m_swapped)
+        {
+            if (m_groups.empty() || m_groups[last].type != entry.type)
+            {
+                last = 0;
+                while (last < m_groups.size() && m_groups[last].type != entry.type)
+                    ++last;
+                if (last == m_groups.size())
+                    m_groups.push_back(Group{entry.type, 0});
+            }
+            entry.group = last;
+            ++m_groups[last].offset;
+        }
+
+        // A single type is already in order.
+        if (m_groups.size() == 1)
+        {
+            m_batch.swap(m_swapped);
+            return true;
+        }
+
+        size_t offset = 0;
+        for (Group &group : m_groups)
+            offset += std::exchange(group.offset, offset);
+
+        m_batch.resize(m_swapped.size());
+        for (const Pending &entry : m_swapped)
+            m_batch[m_groups[entry.group].offset++] = entry;
+        return true;
+    }
+
+    void EventQueue::Dispatch(void *context, const Pending &entry)
+    {
+        // The handler destroys the event even when a listener throws; free its storage either way.
+        struct Free
+        {
+            const Pending &entry;
+            ~Free()
+            {
+                if (entry.record)
+                    std::atomic_ref<uint32_t>(entry.record->state).store(kSkip, std::memory_order_relaxed);
+                else
+                    ::operator delete(entry.payload, std::align_val_t(entry.alignment));
+            }
+        } free{entry};
+
+        entry.handler(context, entry.payload);
+    }
+
+    void EventQueue::ReleaseDispatched()
+    {
+        // Records are dispatched by type, not in ring order; only a done prefix can be reused.
+        uint64_t read = m_read;
+        while (read != m_scan)
+        {
+            Record *record = RecordAt(read);
+            if (std::atomic_ref<uint32_t>(record->state).load(std::memory_order_relaxed) != kSkip)
+                break;
+            // Later records may start anywhere in this space; their state words must read as empty.
+            const uint32_t size = record->size;
+            std::memset(static_cast<void *>(record), 0, size);
+            read += size;
+        }
+
+        if (read != m_read)
+        {
+            m_read = read;
+            m_tail.store(read, std::memory_order_release);
+        }
+    }
+
+    bool EventQueue::HasPending() const
+    {
+        return m_batchNext != m_batch.size() || m_scan != m_head.load(std::memory_order_acquire) ||
+               m_overflowing.load(std::memory_order_acquire);
+    }
+} // namespace cp
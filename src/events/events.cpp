@@ -1,10 +1,21 @@
 #include "cp_framework/events/events.hpp"
+#include "cp_framework/threading/threadPool.hpp"
 
 namespace cp
 {
-    EventDispatcher::EventDispatcher() : m_nextListenerID(1)
+    EventTypeID RegisterEventType(const std::type_info &type)
     {
-        StartAsync();
+        static std::mutex mutex;
+        static std::unordered_map<std::type_index, EventTypeID> ids;
+
+        std::lock_guard lock(mutex);
+        return ids.try_emplace(std::type_index(type), static_cast<EventTypeID>(ids.size())).first->second;
+    }
+
+    EventDispatcher::EventDispatcher(size_t queueCapacity) : m_nextListenerID(1), m_queue(queueCapacity)
+    {
+        m_slotTables.push_back(std::make_unique<const SlotTable>());
+        m_slots.store(m_slotTables.back().get(), std::memory_order_release);
     }
 
     EventDispatcher::~EventDispatcher()
@@ -12,13 +23,18 @@ namespace cp
         StopAsync();
     }
 
+    size_t EventDispatcher::DispatchQueued(std::chrono::nanoseconds budget)
+    {
+        assert(!m_running && "DispatchQueued must not be called while the async thread runs");
+        return m_queue.Consume(this, budget);
+    }
+
     void EventDispatcher::StartAsync()
     {
-        m_running = true;
+        if (m_running.exchange(true))
+            return;
         m_thread = std::thread([this]()
                                { ProcessQueue(); });
-
-        m_cv.notify_one();
     }
 
     void EventDispatcher::StopAsync()
@@ -26,30 +42,189 @@ namespace cp
         if (m_running)
         {
             m_running = false;
-            m_cv.notify_one();
+            m_parked.store(false);
+            m_parked.notify_one();
             if (m_thread.joinable())
                 m_thread.join();
         }
     }
 
+    void EventDispatcher::AddListener(EventTypeID type, ListenerEntry &&entry)
+    {
+        std::lock_guard lock(m_mutex);
+
+        // Writers are serialized by m_mutex, so plain load-copy-store cannot lose an update.
+        const SlotTable *slots = m_slots.load(std::memory_order_acquire);
+        ListenerSlot *slot = type < slots->size() ? (*slots)[type] : nullptr;
+        if (!slot)
+        {
+            m_slotStorage.push_back(std::make_unique<ListenerSlot>());
+            slot = m_slotStorage.back().get();
+
+            // Emitters may still read the old table, so it stays alive with the dispatcher.
+            auto grown = std::make_unique<SlotTable>(*slots);
+            if (type >= grown->size())
+                grown->resize(std::max<size_t>(type + 1, grown->size() * 2), nullptr);
+            (*grown)[type] = slot;
+            m_slotTables.push_back(std::move(grown));
+            m_slots.store(m_slotTables.back().get(), std::memory_order_release);
+        }
+
+        auto next = slot->owner ? std::make_unique<ListenerList>(*slot->owner) : std::make_unique<ListenerList>();
+        // Descending priority; within a priority, serial listeners first, then subscription order.
+        auto position = std::upper_bound(next->begin(), next->end(), entry,
+                                         [](const ListenerEntry &added, const ListenerEntry &other)
+                                         {
+                                             if (added.priority != other.priority)
+                                                 return added.priority > other.priority;
+                                             return added.execution < other.execution;
+                                         });
+        next->insert(position, std::move(entry));
+        Publish(*slot, std::move(next));
+    }
+
+    void EventDispatcher::RemoveListener(EventTypeID type, ListenerID id)
+    {
+        std::lock_guard lock(m_mutex);
+
+        const SlotTable *slots = m_slots.load(std::memory_order_acquire);
+        ListenerSlot *slot = type < slots->size() ? (*slots)[type] : nullptr;
+        if (!slot || !slot->owner)
+            return;
+
+        const ListenerList &current = *slot->owner;
+        auto found = std::find_if(current.begin(), current.end(),
+                                  [id](const ListenerEntry &e)
+                                  { return e.id == id; });
+        if (found == current.end())
+            return;
+
+        auto next = std::make_unique<ListenerList>();
+        next->reserve(current.size() - 1);
+        for (const ListenerEntry &entry : current)
+            if (entry.id != id)
+                next->push_back(entry);
+        Publish(*slot, std::move(next));
+    }
+
+    void EventDispatcher::EmitQueued(EventTypeID type, const Event &event)
+    {
+        ListenerSlot *slot = FindSlot(type);
+        if (!slot)
+            return;
+
+        EmitScope scope(*slot);
+        const ListenerList *listeners = scope.Listeners();
+        if (!listeners)
+            return;
+
+        ThreadPool *pool = m_threadPool.load(std::memory_order_acquire);
+        for (auto tier = listeners->begin(); tier != listeners->end();)
+        {
+            auto parallel = tier;
+            while (parallel != listeners->end() && parallel->priority == tier->priority &&
+                   parallel->execution == ListenerExecution::Serial)
+                (parallel++)->callback(event);
+
+            auto tierEnd = parallel;
+            while (tierEnd != listeners->end() && tierEnd->priority == tier->priority)
+                ++tierEnd;
+
+            // A single parallel listener is not worth a round trip through the pool.
+            if (pool && tierEnd - parallel > 1)
+            {
+                // One batch of listeners per worker plus the dispatching thread, which helps while it waits.
+                const size_t count = static_cast<size_t>(tierEnd - parallel);
+                const size_t threads = pool->GetThreadCount() + 1;
+                pool->ParallelFor(0, count, (count + threads - 1) / threads, [&](size_t begin, size_t end)
+                                  {
+                                      for (size_t i = begin; i < end; ++i)
+                                          parallel[i].callback(event); });
+            }
+            else
+            {
+                for (; parallel != tierEnd; ++parallel)
+                    parallel->callback(event);
+            }
+            tier = tierEnd;
+        }
+    }
+
+    EventDispatcher::ListenerSlot *EventDispatcher::FindSlot(EventTypeID type) const
+    {
+        const SlotTable *slots = m_slots.load(std::memory_order_acquire);
+        return type < slots->size() ? (*slots)[type] : nullptr;
+    }
+
+    void EventDispatcher::Publish(ListenerSlot &slot, std::unique_ptr<const ListenerList> next)
+    {
+        slot.listeners.store(next.get(), std::memory_order_seq_cst);
+        if (slot.owner)
+        {
+            std::lock_guard lock(slot.reclaimMutex);
+            slot.pending.push_back(std::move(slot.owner));
+            slot.hasRetired.store(true, std::memory_order_seq_cst);
+        }
+        slot.owner = std::move(next);
+        ReclaimRetired(slot);
+    }
+
+    void EventDispatcher::ReclaimRetired(ListenerSlot &slot)
+    {
+        // Whoever holds the mutex rechecks the request after unlocking, so a
+        // failed try_lock loses nothing and an emitter never waits.
+        slot.reclaimRequested.store(true, std::memory_order_seq_cst);
+        while (slot.reclaimRequested.load(std::memory_order_seq_cst))
+        {
+            std::unique_lock lock(slot.reclaimMutex, std::try_to_lock);
+            if (!lock.owns_lock())
+                return;
+            slot.reclaimRequested.store(false, std::memory_order_seq_cst);
+            ReclaimRetiredLocked(slot);
+        }
+    }
+
+    void EventDispatcher::ReclaimRetiredLocked(ListenerSlot &slot)
+    {
+        // Epoch flips happen only here, under reclaimMutex. An emit that could
+        // hold a draining snapshot joined the old epoch before the flip that
+        // followed its retirement; one that joined later loads a newer snapshot.
+        const uint32_t current = slot.epoch.load(std::memory_order_relaxed);
+        const uint32_t old = current ^ 1;
+        if (!slot.draining.empty() && slot.readers[old].load(std::memory_order_seq_cst) == 0)
+            slot.draining.clear();
+
+        // Reusing the old epoch needs it empty: emits left in it may hold anything retired since.
+        if (slot.draining.empty() && !slot.pending.empty() && slot.readers[old].load(std::memory_order_seq_cst) == 0)
+        {
+            slot.draining.swap(slot.pending);
+            slot.epoch.store(old, std::memory_order_seq_cst);
+            if (slot.readers[current].load(std::memory_order_seq_cst) == 0)
+                slot.draining.clear();
+        }
+
+        slot.hasRetired.store(!slot.pending.empty() || !slot.draining.empty(), std::memory_order_seq_cst);
+    }
+
     void EventDispatcher::ProcessQueue()
     {
         while (m_running)
         {
-            std::shared_ptr<EventWrapper> ev;
+            if (m_queue.Consume(this))
+                continue;
+
+            // Unlike a counted waiter, the flag is cleared by the first producer
+            // only, so a burst of events costs a single wake-up.
+            m_parked.store(true, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!m_running || m_queue.HasPending())
             {
-                std::unique_lock lock(m_queueMutex);
-                m_cv.wait(lock, [this]()
-                          { return !m_eventQueue.empty() || !m_running; });
-                if (!m_running)
-                    break;
-
-                ev = m_eventQueue.front();
-                m_eventQueue.pop();
+                // An event arrived meanwhile, or a producer is still writing one.
+                m_parked.store(false, std::memory_order_relaxed);
+                std::this_thread::yield();
+                continue;
             }
-
-            if (ev)
-                ev->Dispatch(this);
+            m_parked.wait(true, std::memory_order_acquire);
         }
     }
 }
\ No newline at end of file
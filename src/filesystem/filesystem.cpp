@@ -133,7 +133,7 @@ namespace cp::filesystem
         m_size = static_cast<size_t>(size.QuadPart);
         return true;
 #else
-        m_fd = open(filepath.string().c_str(), O_RDONLY);
+        m_fd = ::open(filepath.string().c_str(), O_RDONLY);
         if (m_fd < 0)
             return false;
 
@@ -199,6 +199,15 @@ namespace cp::filesystem
         }
     }
 
+    Task<FileBytes> ReadBytesAsync(ThreadPool &pool, file_path path, TaskPriority priority)
+    {
+        co_await pool.Schedule(priority);
+
+        FileBytes file;
+        file.data = ReadBytes(path, file.size);
+        co_return file;
+    }
+
     void WriteBytes(const file_path &path, std::span<const uint8_t> data, bool append)
     {
         auto file = NormalizePath(path);
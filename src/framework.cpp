@@ -6,11 +6,22 @@
 #include "cp_framework/time/gameTime.hpp"
 #include "cp_framework/window/window.hpp"
 #include "cp_framework/threading/threadPool.hpp"
+#include "cp_framework/threading/jobFence.hpp"
+#include "cp_framework/threading/mainThreadQueue.hpp"
 #include "cp_framework/input/inputManager.hpp"
 #include "cp_framework/vulkan/manager.hpp"
 
 namespace cp
 {
+    namespace
+    {
+        /// @brief Per-frame time the main thread spends on work posted by other threads.
+        constexpr std::chrono::microseconds kMainThreadBudget{2000};
+
+        /// @brief Per-frame time the main thread spends dispatching queued events.
+        constexpr std::chrono::microseconds kQueuedEventBudget{2000};
+    }
+
     Framework::Framework()
     {
         ScopedLog slog("FRAMEWORK", "Creating framework class", "Successfully created framework class");
@@ -22,6 +33,8 @@ namespace cp
     Framework::~Framework()
     {
         ScopedLog slog("FRAMEWORK", "Destroying framework class", "Successfully destroyed framework class");
+        // The event system outlives the pool.
+        EventSystem::Get().SetThreadPool(nullptr);
     }
 
     void Framework::Init()
@@ -31,8 +44,12 @@ namespace cp
         // Create modules
         WindowInfo createInfo{.width = 1320, .height = 780, .title = "CP_FRAMEWORK", .mode = WindowMode::Windowed, .vsync = true};
         m_window = M_UPTR<Window>(createInfo);
+        m_mainThreadQueue = M_UPTR<MainThreadQueue>();
         m_threadPool = M_UPTR<ThreadPool>();
+        m_frameJobs = M_UPTR<JobFence>(*m_threadPool);
         m_diag = M_UPTR<DiagnosticsManager>();
+        m_diag->SetThreadPool(m_threadPool.get());
+        EventSystem::Get().SetThreadPool(m_threadPool.get());
         m_input = M_UPTR<InputManager>(m_window->GetWindowHandle());
         m_vkManager = M_UPTR<VkManager>(m_window->GetWindowHandle());
 
@@ -62,6 +79,16 @@ namespace cp
 
             m_input->update();
 
+            // -----------------------------
+            // Main-thread work posted by other threads (budgeted)
+            // -----------------------------
+            m_mainThreadQueue->Drain(kMainThreadBudget);
+
+            // -----------------------------
+            // Events queued since the last frame (budgeted)
+            // -----------------------------
+            EventSystem::Get().DispatchQueued(kQueuedEventBudget);
+
             // -----------------------------
             // Update global game time
             // -----------------------------
@@ -82,6 +109,11 @@ namespace cp
                 fixedUpdate(gameTime.FixedDeltaTime());
             }
 
+            // -----------------------------
+            // Join frame jobs (main thread helps)
+            // -----------------------------
+            m_frameJobs->Wait();
+
             // -----------------------------
             // Late update / rendering
             // -----------------------------
@@ -93,6 +125,24 @@ namespace cp
         LOG_SUCCESS("[FRAMEWORK] Successfully terminanted game loop!");
     }
 
+    ThreadPool &Framework::GetThreadPool()
+    {
+        assert(m_initializated && "Init function must be called before GetThreadPool");
+        return *m_threadPool;
+    }
+
+    JobFence &Framework::GetFrameJobs()
+    {
+        assert(m_initializated && "Init function must be called before GetFrameJobs");
+        return *m_frameJobs;
+    }
+
+    MainThreadQueue &Framework::GetMainThreadQueue()
+    {
+        assert(m_initializated && "Init function must be called before GetMainThreadQueue");
+        return *m_mainThreadQueue;
+    }
+
     void Framework::update(const f64 &deltaTime)
     {
         (void)deltaTime;
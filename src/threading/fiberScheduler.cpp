@@ -0,0 +1,384 @@
+#include "cp_framework/threading/fiberScheduler.hpp"
+#include "cp_framework/debug/debug.hpp"
+#include <algorithm>
+#include <new>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
+
+#if defined(_MSC_VER)
+#define CP_FIBER_NOINLINE __declspec(noinline)
+#else
+#define CP_FIBER_NOINLINE __attribute__((noinline))
+#endif
+
+namespace cp
+{
+    namespace
+    {
+        thread_local void *t_currentFiber = nullptr; ///< Fiber running on this thread, if any.
+
+        // Fibers migrate between threads. Accessing the thread_local through
+        // opaque calls stops the compiler from caching its address across a
+        // switch point, which would read the previous thread's slot.
+        CP_FIBER_NOINLINE void *CurrentFiber() { return t_currentFiber; }
+        CP_FIBER_NOINLINE void SetCurrentFiber(void *fiber) { t_currentFiber = fiber; }
+    }
+
+    /**
+     * @brief A user-mode execution context with its own stack.
+     */
+    struct FiberScheduler::Fiber
+    {
+        /**
+         * @brief What the fiber asked for when it last switched out.
+         */
+        enum class State
+        {
+            Idle,     ///< In the free list.
+            Running,  ///< Executing a job.
+            Waiting,  ///< Suspended in WaitForCounter().
+            Finished, ///< Job done; ready to be recycled.
+            Failed    ///< Could not be resumed; the stack stays untouched until destruction.
+        };
+
+        FiberScheduler *owner = nullptr;   ///< Scheduler the fiber belongs to.
+        State state = State::Idle;         ///< Set by the fiber before switching out.
+        Job job;                           ///< Job to run next.
+        JobCounter *counter = nullptr;     ///< Counter signalled when the job finishes.
+        JobCounter *waitCounter = nullptr; ///< Counter waited on while Waiting.
+        int64_t waitTarget = 0;            ///< Value waited for while Waiting.
+        Fiber *next = nullptr;             ///< Free-list / waiter-list link.
+
+#if defined(_WIN32)
+        void *handle = nullptr; ///< Win32 fiber.
+        void *caller = nullptr; ///< Fiber (converted thread) that switched in.
+#else
+        ucontext_t context{};    ///< Saved context of the fiber.
+        ucontext_t caller{};     ///< Saved context of whoever switched in.
+        void *mapping = nullptr; ///< Guard page + stack.
+        size_t mappingSize = 0;  ///< Size of @ref mapping.
+#endif
+
+        /**
+         * @brief Returns the fiber running on the calling thread, if any.
+         */
+        static Fiber *Current() { return static_cast<Fiber *>(CurrentFiber()); }
+
+        /**
+         * @brief Jumps from the calling context into this fiber, returning when it switches out.
+         */
+        void SwitchIn()
+        {
+#if defined(_WIN32)
+            if (!IsThreadAFiber())
+                ConvertThreadToFiber(nullptr);
+            caller = GetCurrentFiber();
+            SwitchToFiber(handle);
+#else
+            swapcontext(&caller, &context);
+#endif
+        }
+
+        /**
+         * @brief Jumps from this fiber back to the context that switched it in.
+         */
+        void SwitchOut()
+        {
+#if defined(_WIN32)
+            SwitchToFiber(caller);
+#else
+            swapcontext(&context, &caller);
+#endif
+        }
+
+#if defined(_WIN32)
+        static void WINAPI Entry(void *parameter)
+        {
+            FiberMain(static_cast<Fiber *>(parameter));
+        }
+#else
+        static void Entry()
+        {
+            // makecontext() cannot portably pass a pointer; Resume() published the fiber first.
+            FiberMain(Current());
+        }
+#endif
+    };
+
+    FiberScheduler::FiberScheduler(ThreadPool &pool, const FiberConfig &config)
+        : m_pool(pool),
+          m_config(config)
+    {
+        std::lock_guard<std::mutex> lock(m_fiberMutex);
+        m_fibers.reserve(config.fiberCount);
+        for (size_t i = 0; i < config.fiberCount; ++i)
+        {
+            Fiber *fiber = CreateFiber();
+            fiber->next = m_freeFibers;
+            m_freeFibers = fiber;
+        }
+    }
+
+    FiberScheduler::~FiberScheduler()
+    {
+        m_pool.WaitUntil([this]
+                         { return m_active.load(std::memory_order_acquire) == 0; });
+
+        std::lock_guard<std::mutex> lock(m_fiberMutex);
+        for (Fiber *fiber : m_fibers)
+            DestroyFiber(fiber);
+        m_fibers.clear();
+        m_freeFibers = nullptr;
+    }
+
+    bool FiberScheduler::InFiber() const
+    {
+        const Fiber *fiber = Fiber::Current();
+        return fiber && fiber->owner == this;
+    }
+
+    void FiberScheduler::Launch(Job &&body, JobCounter *counter)
+    {
+        Fiber *fiber = AcquireFiber();
+        fiber->job = std::move(body);
+        fiber->counter = counter;
+        fiber->state = Fiber::State::Running;
+        Resume(fiber);
+    }
+
+    void FiberScheduler::Resume(Fiber *fiber)
+    {
+        while (true)
+        {
+            void *previous = CurrentFiber();
+            SetCurrentFiber(fiber);
+            m_switchCount.fetch_add(2, std::memory_order_relaxed);
+            fiber->SwitchIn();
+            SetCurrentFiber(previous);
+
+            // We are off the fiber's stack now, so it is safe to hand it to other threads.
+            if (fiber->state == Fiber::State::Finished)
+            {
+                ReleaseFiber(fiber);
+                m_active.fetch_sub(1, std::memory_order_release);
+                return;
+            }
+
+            if (Park(fiber))
+                return;
+
+            // The counter reached its target while the fiber was switching out: continue it here.
+            fiber->state = Fiber::State::Running;
+        }
+    }
+
+    bool FiberScheduler::Park(Fiber *fiber)
+    {
+        JobCounter &counter = *fiber->waitCounter;
+
+        // Announce first, then check: pairs with Signal() (decrement, then look for waiters).
+        counter.m_waiterCount.fetch_add(1, std::memory_order_seq_cst);
+        std::lock_guard<std::mutex> lock(counter.m_mutex);
+        if (counter.m_value.load(std::memory_order_seq_cst) <= fiber->waitTarget)
+        {
+            counter.m_waiterCount.fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        fiber->next = counter.m_waiters;
+        counter.m_waiters = fiber;
+        return true;
+    }
+
+    void FiberScheduler::Signal(JobCounter &counter)
+    {
+        counter.m_value.fetch_sub(1, std::memory_order_seq_cst);
+        if (counter.m_waiterCount.load(std::memory_order_seq_cst) == 0)
+            return;
+
+        Fiber *ready = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(counter.m_mutex);
+            const int64_t value = counter.m_value.load(std::memory_order_relaxed);
+
+            Fiber **link = &counter.m_waiters;
+            while (Fiber *waiter = *link)
+            {
+                if (value <= waiter->waitTarget)
+                {
+                    *link = waiter->next;
+                    waiter->next = ready;
+                    ready = waiter;
+                    counter.m_waiterCount.fetch_sub(1, std::memory_order_relaxed);
+                }
+                else
+                {
+                    link = &waiter->next;
+                }
+            }
+        }
+
+        // Owns the fiber until the resume job runs; a job destroyed unrun fails the fiber instead of stranding it.
+        struct PendingResume
+        {
+            FiberScheduler *scheduler;
+            Fiber *fiber;
+
+            PendingResume(FiberScheduler *owner, Fiber *suspended) : scheduler(owner), fiber(suspended) {}
+            PendingResume(PendingResume &&other) noexcept
+                : scheduler(std::exchange(other.scheduler, nullptr)), fiber(other.fiber) {}
+            ~PendingResume()
+            {
+                if (scheduler)
+                    scheduler->FailFiber(fiber);
+            }
+        };
+
+        // Resumed fibers hold stacks and usually finish a chain of work: let them jump the queue.
+        while (ready)
+        {
+            Fiber *fiber = ready;
+            ready = fiber->next;
+            fiber->next = nullptr;
+            fiber->state = Fiber::State::Running;
+            try
+            {
+                m_pool.Dispatch(TaskPriority::HIGH, [resume = PendingResume(this, fiber)]() mutable
+                                { std::exchange(resume.scheduler, nullptr)->Resume(resume.fiber); });
+            }
+            catch (...)
+            {
+                // The rejected job already failed the fiber; an exception must not unwind through a fiber switch.
+            }
+        }
+    }
+
+    void FiberScheduler::Abandon(JobCounter *counter)
+    {
+        if (counter)
+            Signal(*counter);
+        m_active.fetch_sub(1, std::memory_order_release);
+    }
+
+    void FiberScheduler::FailFiber(Fiber *fiber)
+    {
+        fiber->state = Fiber::State::Failed;
+        LOG_ERROR("[FIBER] Failed to resume a suspended fiber; its job is abandoned");
+        Abandon(std::exchange(fiber->counter, nullptr));
+    }
+
+    void FiberScheduler::WaitForCounter(JobCounter &counter, int64_t target)
+    {
+        if (counter.Value() <= target)
+            return;
+
+        Fiber *fiber = Fiber::Current();
+        if (!fiber || fiber->owner != this)
+        {
+            m_pool.WaitUntil([&counter, target]
+                             { return counter.Value() <= target; });
+            return;
+        }
+
+        fiber->waitCounter = &counter;
+        fiber->waitTarget = target;
+        fiber->state = Fiber::State::Waiting;
+        fiber->SwitchOut();
+        fiber->waitCounter = nullptr;
+    }
+
+    void FiberScheduler::FiberMain(Fiber *fiber)
+    {
+        while (true)
+        {
+            fiber->job();
+            fiber->job.Reset();
+
+            FiberScheduler &owner = *fiber->owner;
+            if (JobCounter *counter = std::exchange(fiber->counter, nullptr))
+                owner.Signal(*counter);
+
+            // m_active drops in Resume(), once this stack is no longer in use.
+            fiber->state = Fiber::State::Finished;
+            fiber->SwitchOut();
+        }
+    }
+
+    FiberScheduler::Fiber *FiberScheduler::AcquireFiber()
+    {
+        std::lock_guard<std::mutex> lock(m_fiberMutex);
+        Fiber *fiber = m_freeFibers;
+        if (fiber)
+            m_freeFibers = fiber->next;
+        else
+            fiber = CreateFiber();
+        fiber->next = nullptr;
+        return fiber;
+    }
+
+    void FiberScheduler::ReleaseFiber(Fiber *fiber)
+    {
+        fiber->state = Fiber::State::Idle;
+        std::lock_guard<std::mutex> lock(m_fiberMutex);
+        fiber->next = m_freeFibers;
+        m_freeFibers = fiber;
+    }
+
+    FiberScheduler::Fiber *FiberScheduler::CreateFiber()
+    {
+        auto *fiber = new Fiber();
+        fiber->owner = this;
+
+#if defined(_WIN32)
+        fiber->handle = ::CreateFiber(m_config.stackSize, &Fiber::Entry, fiber);
+        if (!fiber->handle)
+        {
+            delete fiber;
+            throw std::bad_alloc();
+        }
+#else
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t stackSize = (std::max<size_t>(m_config.stackSize, page) + page - 1) / page * page;
+
+        fiber->mappingSize = stackSize + page;
+        fiber->mapping = mmap(nullptr, fiber->mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (fiber->mapping == MAP_FAILED)
+        {
+            delete fiber;
+            throw std::bad_alloc();
+        }
+        // Stacks grow down: the lowest page is the guard.
+        mprotect(fiber->mapping, page, PROT_NONE);
+
+        getcontext(&fiber->context);
+        fiber->context.uc_stack.ss_sp = static_cast<char *>(fiber->mapping) + page;
+        fiber->context.uc_stack.ss_size = stackSize;
+        fiber->context.uc_link = nullptr;
+        makecontext(&fiber->context, &Fiber::Entry, 0);
+#endif
+
+        m_fibers.push_back(fiber);
+        m_fiberCount.fetch_add(1, std::memory_order_relaxed);
+        return fiber;
+    }
+
+    void FiberScheduler::DestroyFiber(Fiber *fiber)
+    {
+#if defined(_WIN32)
+        DeleteFiber(fiber->handle);
+#else
+        munmap(fiber->mapping, fiber->mappingSize);
+#endif
+        delete fiber;
+    }
+} // namespace cp
@@ -0,0 +1,104 @@
+#include "cp_framework/threading/mainThreadQueue.hpp"
+#include <cassert>
+#include <memory>
+
+namespace cp
+{
+    /**
+     * @brief Queue node: a job and the link to the next newer node.
+     */
+    struct MainThreadQueue::Node
+    {
+        std::atomic<Node *> next{nullptr}; ///< Newer node, published by its producer.
+        Job job;                           ///< Task to run (empty for the stub).
+    };
+
+    MainThreadQueue::MainThreadQueue()
+        : m_stub(new Node()),
+          m_mainThread(std::this_thread::get_id())
+    {
+        m_head.store(m_stub, std::memory_order_relaxed);
+        m_tail = m_stub;
+    }
+
+    MainThreadQueue::~MainThreadQueue()
+    {
+        while (Node *node = Pop())
+            delete node;
+        delete m_stub;
+    }
+
+    void MainThreadQueue::Push(Job &&job)
+    {
+        Node *node = new Node();
+        node->job = std::move(job);
+        m_pending.fetch_add(1, std::memory_order_relaxed);
+        PushNode(node);
+    }
+
+    void MainThreadQueue::PushNode(Node *node)
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        // The exchange serializes producers; until the store below the consumer sees a gap and waits.
+        Node *previous = m_head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    MainThreadQueue::Node *MainThreadQueue::Pop()
+    {
+        Node *tail = m_tail;
+        Node *next = tail->next.load(std::memory_order_acquire);
+
+        if (tail == m_stub)
+        {
+            if (!next)
+                return nullptr;
+            m_tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next)
+        {
+            m_tail = next;
+            return tail;
+        }
+
+        // tail is the last linked node: unless a producer is mid-push, re-insert the stub behind it.
+        if (tail != m_head.load(std::memory_order_acquire))
+            return nullptr;
+
+        PushNode(m_stub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next)
+        {
+            m_tail = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+    size_t MainThreadQueue::Drain(std::chrono::nanoseconds budget)
+    {
+        assert(IsMainThread() && "MainThreadQueue::Drain must be called from the main thread");
+
+        const auto start = std::chrono::steady_clock::now();
+        const size_t limit = m_pending.load(std::memory_order_acquire);
+
+        size_t ran = 0;
+        while (ran < limit)
+        {
+            std::unique_ptr<Node> node(Pop());
+            if (!node)
+                break;
+
+            m_pending.fetch_sub(1, std::memory_order_relaxed);
+            ++ran;
+            node->job();
+
+            if (std::chrono::steady_clock::now() - start >= budget)
+                break;
+        }
+        return ran;
+    }
+} // namespace cp
@@ -0,0 +1,253 @@
+#include "cp_framework/threading/taskGraph.hpp"
+#include "cp_framework/threading/threadPool.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace cp
+{
+    TaskGraph::Node &TaskGraph::Node::Precede(Node successor)
+    {
+        m_graph->AddDependency(*this, successor);
+        return *this;
+    }
+
+    TaskGraph::Node &TaskGraph::Node::Succeed(Node predecessor)
+    {
+        m_graph->AddDependency(predecessor, *this);
+        return *this;
+    }
+
+    TaskGraph::Node TaskGraph::Node::Then(std::function<void()> work)
+    {
+        Node next = m_graph->Emplace(std::move(work));
+        m_graph->AddDependency(*this, next);
+        return next;
+    }
+
+    TaskGraph::~TaskGraph()
+    {
+        if (!IsComplete())
+        {
+            try
+            {
+                Wait();
+            }
+            catch (...)
+            {
+                // Errors of an abandoned run have nowhere to go.
+            }
+        }
+    }
+
+    TaskGraph::Node TaskGraph::Emplace(std::function<void()> work)
+    {
+        return AddNode(std::move(work), false);
+    }
+
+    void TaskGraph::AddDependency(Node before, Node after)
+    {
+        if (before.m_graph != this || after.m_graph != this)
+            throw std::invalid_argument("TaskGraph::AddDependency: node belongs to another graph");
+        if (!IsComplete())
+            throw std::logic_error("TaskGraph: cannot modify a running graph");
+
+        m_nodes[before.m_index].successors.push_back(after.m_index);
+        m_nodes[after.m_index].predecessorCount++;
+        m_validated = false;
+    }
+
+    TaskGraph::Node TaskGraph::WhenAll(std::initializer_list<Node> nodes, std::function<void()> work)
+    {
+        Node join = AddNode(std::move(work), false);
+        for (Node node : nodes)
+            AddDependency(node, join);
+        return join;
+    }
+
+    TaskGraph::Node TaskGraph::WhenAny(std::initializer_list<Node> nodes, std::function<void()> work)
+    {
+        Node race = AddNode(std::move(work), true);
+        for (Node node : nodes)
+            AddDependency(node, race);
+        return race;
+    }
+
+    void TaskGraph::Run(ThreadPool &pool)
+    {
+        if (!IsComplete())
+            throw std::logic_error("TaskGraph::Run: previous run still in flight");
+        if (m_nodes.empty())
+            return;
+        if (!pool.IsRunning())
+            throw std::runtime_error("TaskGraph::Run: thread pool is shut down");
+
+        if (!m_validated)
+            Validate();
+
+        m_pool = &pool;
+        m_error = nullptr;
+        m_aborted.store(false, std::memory_order_relaxed);
+        for (NodeData &node : m_nodes)
+            node.remaining.store(node.anyOf ? std::min<size_t>(node.predecessorCount, 1) : node.predecessorCount,
+                                 std::memory_order_relaxed);
+        m_outstanding.store(m_nodes.size(), std::memory_order_release);
+
+        for (size_t i = 0; i < m_nodes.size(); ++i)
+            if (m_nodes[i].predecessorCount == 0)
+                Schedule(i);
+    }
+
+    void TaskGraph::Wait()
+    {
+        if (m_pool)
+            m_pool->WaitUntil([this]
+                              { return IsComplete(); },
+                              TaskPriority::NORMAL);
+
+        if (m_error)
+            std::rethrow_exception(std::exchange(m_error, nullptr));
+    }
+
+    void TaskGraph::Clear()
+    {
+        if (!IsComplete())
+            throw std::logic_error("TaskGraph: cannot modify a running graph");
+
+        m_nodes.clear();
+        m_validated = false;
+    }
+
+    TaskGraph::Node TaskGraph::AddNode(std::function<void()> work, bool anyOf)
+    {
+        if (!IsComplete())
+            throw std::logic_error("TaskGraph: cannot modify a running graph");
+
+        NodeData &node = m_nodes.emplace_back();
+        node.work = std::move(work);
+        node.anyOf = anyOf;
+        m_validated = false;
+        return Node(this, m_nodes.size() - 1);
+    }
+
+    void TaskGraph::Validate()
+    {
+        std::vector<size_t> inDegree(m_nodes.size());
+        std::vector<size_t> ready;
+        for (size_t i = 0; i < m_nodes.size(); ++i)
+        {
+            inDegree[i] = m_nodes[i].predecessorCount;
+            if (inDegree[i] == 0)
+                ready.push_back(i);
+        }
+
+        size_t visited = 0;
+        while (!ready.empty())
+        {
+            const size_t index = ready.back();
+            ready.pop_back();
+            ++visited;
+            for (size_t successor : m_nodes[index].successors)
+                if (--inDegree[successor] == 0)
+                    ready.push_back(successor);
+        }
+
+        if (visited != m_nodes.size())
+            throw std::logic_error("TaskGraph: dependency cycle detected");
+
+        m_validated = true;
+    }
+
+    void TaskGraph::Schedule(size_t index)
+    {
+        if (m_aborted.load(std::memory_order_acquire))
+        {
+            Drop(index);
+            return;
+        }
+
+        // Owns the node until the job runs; a job destroyed unrun drops the node so Wait() still returns.
+        struct PendingNode
+        {
+            TaskGraph *graph;
+            size_t index;
+
+            PendingNode(TaskGraph *owner, size_t node) : graph(owner), index(node) {}
+            PendingNode(PendingNode &&other) noexcept
+                : graph(std::exchange(other.graph, nullptr)), index(other.index) {}
+            ~PendingNode()
+            {
+                if (graph)
+                    graph->Drop(index);
+            }
+        };
+
+        try
+        {
+            m_pool->Dispatch(TaskPriority::NORMAL, [node = PendingNode(this, index)]() mutable
+                             { std::exchange(node.graph, nullptr)->Execute(node.index); });
+        }
+        catch (...)
+        {
+            // The rejected job already dropped the node; a worker running Execute() must not see the exception.
+        }
+    }
+
+    void TaskGraph::Execute(size_t index)
+    {
+        NodeData &node = m_nodes[index];
+        if (node.work)
+        {
+            try
+            {
+                node.work();
+            }
+            catch (...)
+            {
+                Fail(std::current_exception());
+            }
+        }
+
+        for (size_t successor : node.successors)
+            if (Release(successor))
+                Schedule(successor);
+
+        // Last access to the graph: the waiter may return right after this.
+        m_outstanding.fetch_sub(1, std::memory_order_release);
+    }
+
+    bool TaskGraph::Release(size_t index)
+    {
+        NodeData &node = m_nodes[index];
+        if (node.anyOf)
+            return node.remaining.exchange(0, std::memory_order_acq_rel) == 1;
+        return node.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+
+    void TaskGraph::Drop(size_t index)
+    {
+        Fail(std::make_exception_ptr(std::runtime_error("TaskGraph: node dropped without running")));
+        m_aborted.store(true, std::memory_order_release);
+
+        // Iterative: a long chain behind the dropped node must not recurse once per node.
+        std::vector<size_t> dropped{index};
+        while (!dropped.empty())
+        {
+            const size_t current = dropped.back();
+            dropped.pop_back();
+            for (size_t successor : m_nodes[current].successors)
+                if (Release(successor))
+                    dropped.push_back(successor);
+
+            // Every node still in the list is outstanding, so this reaches zero only on the last one.
+            m_outstanding.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    void TaskGraph::Fail(std::exception_ptr error)
+    {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        if (!m_error)
+            m_error = std::move(error);
+    }
+} // namespace cp
@@ -1,17 +1,637 @@
 #include "cp_framework/threading/threadPool.hpp"
+#include "cp_framework/debug/debug.hpp"
 #include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace cp
 {
+    /**
+     * @brief Queue node wrapping a Job. Nodes are recycled, never freed in steady state.
+     */
+    struct ThreadPool::JobNode
+    {
+        Job job;                 ///< The task to execute.
+        JobNode *next = nullptr; ///< Inbox / free-list link.
+        int64_t enqueuedNs = 0;  ///< Steady-clock ns of submission (elastic pools only).
+        CancellationToken token; ///< Drops the job at dequeue once cancelled.
+        int64_t deadlineNs = 0;  ///< Steady-clock ns after which the job is dropped; 0 = none.
+        uint64_t taskId = 0;     ///< Deterministic pools: id used for placement and the schedule log.
+    };
+
+    namespace
+    {
+        thread_local const ThreadPool *t_pool = nullptr; ///< Pool owning the current thread, if any.
+        thread_local size_t t_workerIndex = 0;          ///< Worker index of the current thread inside t_pool.
+        thread_local size_t t_submitCursor = 0;         ///< Round-robin cursor for external submissions.
+        thread_local uint64_t t_submitRng = 0;          ///< Xorshift state for external submissions (0 = unseeded).
+        thread_local uint64_t t_taskId = 0;             ///< Deterministic pools: id of the task running on this worker.
+        thread_local uint64_t t_childIndex = 0;         ///< Deterministic pools: tasks submitted so far by that task.
+
+        /**
+         * @brief Hints the CPU that the caller is spin-waiting.
+         */
+        inline void CpuRelax()
+        {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield");
+#endif
+        }
+
+        /**
+         * @brief Returns the steady clock in nanoseconds.
+         */
+        int64_t SteadyNowNs()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        }
+
+        /**
+         * @brief Runs a pool job; an escaping exception terminates the program.
+         *
+         * Dispatch() jobs have nowhere to report an error. Enforcing noexcept
+         * here keeps that true on every path, including the non-worker
+         * threads that run jobs from TryRunPendingTask() and WaitUntil(),
+         * where the exception would otherwise surface in the waiter and leak
+         * the job's node.
+         */
+        void RunJob(Job &job) noexcept
+        {
+            job();
+        }
+
+        /**
+         * @brief Returns the next value of the calling thread's xorshift64 generator.
+         */
+        uint64_t NextSubmitRandom()
+        {
+            if (t_submitRng == 0)
+            {
+                // Seed per thread so that concurrent producers start on different queues.
+                t_submitRng = std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1;
+                t_submitCursor = static_cast<size_t>(t_submitRng);
+            }
+
+            uint64_t x = t_submitRng;
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            t_submitRng = x;
+            return x;
+        }
+
+        /**
+         * @brief SplitMix64 finalizer: a cheap, well-mixed bijection on 64-bit values.
+         */
+        uint64_t Mix64(uint64_t x)
+        {
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+            return x ^ (x >> 31);
+        }
+
+        /**
+         * @brief Id of the @p index-th child of task @p parent (never 0).
+         */
+        uint64_t ChildTaskId(uint64_t parent, uint64_t index)
+        {
+            const uint64_t id = Mix64(parent + index * 0x9e3779b97f4a7c15ull);
+            return id ? id : 1;
+        }
+
+        /**
+         * @brief A CPU usable by the pool and the NUMA node it belongs to.
+         */
+        struct CpuSlot
+        {
+            uint32_t cpu;
+            uint32_t node;
+        };
+
+        /**
+         * @brief Parses a Linux CPU list such as "0-3,8-11".
+         */
+        [[maybe_unused]] std::vector<uint32_t> ParseCpuList(const std::string &text)
+        {
+            std::vector<uint32_t> cpus;
+            std::stringstream stream(text);
+            std::string range;
+            while (std::getline(stream, range, ','))
+            {
+                if (range.empty())
+                    continue;
+                const size_t dash = range.find('-');
+                const uint32_t first = static_cast<uint32_t>(std::stoul(range.substr(0, dash)));
+                const uint32_t last = dash == std::string::npos ? first : static_cast<uint32_t>(std::stoul(range.substr(dash + 1)));
+                for (uint32_t cpu = first; cpu <= last; ++cpu)
+                    cpus.push_back(cpu);
+            }
+            return cpus;
+        }
+
+        /**
+         * @brief Returns the CPUs the process may run on.
+         */
+        std::vector<uint32_t> AllowedCpus()
+        {
+            std::vector<uint32_t> cpus;
+#if defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (sched_getaffinity(0, sizeof(set), &set) == 0)
+                for (uint32_t cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                    if (CPU_ISSET(cpu, &set))
+                        cpus.push_back(cpu);
+#endif
+            if (cpus.empty())
+            {
+                const uint32_t count = std::max(1u, std::thread::hardware_concurrency());
+                for (uint32_t cpu = 0; cpu < count; ++cpu)
+                    cpus.push_back(cpu);
+            }
+            return cpus;
+        }
+
+        /**
+         * @brief Returns the NUMA node of every listed CPU (0 when the topology is unknown).
+         */
+        std::vector<CpuSlot> ResolveNodes(const std::vector<uint32_t> &cpus)
+        {
+            std::vector<CpuSlot> slots;
+            slots.reserve(cpus.size());
+            for (uint32_t cpu : cpus)
+                slots.push_back({cpu, 0});
+
+#if defined(_WIN32)
+            for (CpuSlot &slot : slots)
+            {
+                UCHAR node = 0;
+                if (slot.cpu <= 0xFF && GetNumaProcessorNode(static_cast<UCHAR>(slot.cpu), &node))
+                    slot.node = node;
+            }
+#elif defined(__linux__)
+            std::error_code ec;
+            for (const auto &entry : std::filesystem::directory_iterator("/sys/devices/system/node", ec))
+            {
+                const std::string name = entry.path().filename().string();
+                if (name.rfind("node", 0) != 0 || name.size() == 4 ||
+                    name.find_first_not_of("0123456789", 4) != std::string::npos)
+                    continue;
+
+                std::ifstream file(entry.path() / "cpulist");
+                std::string list;
+                if (!std::getline(file, list))
+                    continue;
+
+                const uint32_t node = static_cast<uint32_t>(std::stoul(name.substr(4)));
+                for (uint32_t cpu : ParseCpuList(list))
+                    for (CpuSlot &slot : slots)
+                        if (slot.cpu == cpu)
+                            slot.node = node;
+            }
+#endif
+            return slots;
+        }
+
+        /**
+         * @brief Process-wide magazine allocator for job nodes.
+         *
+         * Every thread keeps a private free list. When it runs dry it grabs a
+         * whole batch from a shared depot (one lock per kBatchSize nodes);
+         * when it grows past two batches it hands one back. Producers and
+         * consumers living on different threads therefore settle into a
+         * steady state with no heap traffic and rare, amortized locking.
+         */
+        template <typename Node>
+        class NodeCache
+        {
+            static constexpr size_t kBatchSize = 64;
+
+            struct Chain
+            {
+                Node *head;
+                size_t count;
+            };
+
+            /**
+             * @brief Shared pool of node chains.
+             *
+             * Intentionally leaked so it stays valid while thread_local caches
+             * are torn down during process exit.
+             */
+            struct Depot
+            {
+                std::mutex mutex;
+                std::vector<Chain> chains;
+            };
+
+            static Depot &GetDepot()
+            {
+                static Depot *depot = new Depot();
+                return *depot;
+            }
+
+        public:
+            ~NodeCache()
+            {
+                if (m_head)
+                    Release({m_head, m_count});
+            }
+
+            Node *Acquire()
+            {
+                if (!m_head)
+                    Refill();
+
+                if (!m_head)
+                    return new Node();
+
+                Node *node = m_head;
+                m_head = node->next;
+                --m_count;
+                node->next = nullptr;
+                return node;
+            }
+
+            void Recycle(Node *node)
+            {
+                node->next = m_head;
+                m_head = node;
+
+                if (++m_count >= 2 * kBatchSize)
+                {
+                    // Split off a batch and hand it back to the depot.
+                    Node *batch = m_head;
+                    Node *last = batch;
+                    for (size_t i = 1; i < kBatchSize; ++i)
+                        last = last->next;
+                    m_head = last->next;
+                    last->next = nullptr;
+                    m_count -= kBatchSize;
+                    Release({batch, kBatchSize});
+                }
+            }
+
+        private:
+            void Refill()
+            {
+                Depot &depot = GetDepot();
+                std::lock_guard<std::mutex> lock(depot.mutex);
+                if (depot.chains.empty())
+                    return;
+
+                Chain chain = depot.chains.back();
+                depot.chains.pop_back();
+                m_head = chain.head;
+                m_count = chain.count;
+            }
+
+            static void Release(Chain chain)
+            {
+                Depot &depot = GetDepot();
+                std::lock_guard<std::mutex> lock(depot.mutex);
+                depot.chains.push_back(chain);
+            }
+
+            Node *m_head = nullptr;
+            size_t m_count = 0;
+        };
+
+        /**
+         * @brief Returns the calling thread's node free list.
+         */
+        template <typename Node>
+        NodeCache<Node> &LocalNodeCache()
+        {
+            thread_local NodeCache<Node> cache;
+            return cache;
+        }
+
+        /**
+         * @brief Returns the default configuration with @p threadCount workers.
+         */
+        ThreadPoolConfig ConfigWithThreads(size_t threadCount)
+        {
+            ThreadPoolConfig config;
+            config.threadCount = threadCount;
+            return config;
+        }
+    }
+
     ThreadPool::ThreadPool(size_t threadCount)
+        : ThreadPool(ConfigWithThreads(threadCount))
+    {
+    }
+
+    ThreadPool::ThreadPool(const ThreadPoolConfig &config)
         : m_running(true),
-          m_queues(threadCount),
-          m_mutexes(threadCount),
-          m_conditions(threadCount),
-          m_dist(0, threadCount - 1)
+          m_config(config),
+          m_startTime(std::chrono::steady_clock::now())
     {
+        const size_t threadCount = std::max<size_t>(1, config.threadCount);
+        m_deterministic = config.deterministic;
+        m_elastic = !m_deterministic && config.minThreadCount != 0 && config.minThreadCount < threadCount;
+        m_minWorkers = m_elastic ? config.minThreadCount : threadCount;
+
+        m_queues.reserve(threadCount);
         for (size_t i = 0; i < threadCount; ++i)
-            m_workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+            m_queues.emplace_back(std::make_unique<WorkerQueue>());
+        m_workers.resize(threadCount);
+
+        PlaceWorkers();
+
+        if (m_deterministic)
+        {
+            m_rootTaskId = Mix64(config.seed);
+            if (config.replay)
+            {
+                if (config.replay->threadCount != threadCount || config.replay->seed != config.seed)
+                    LOG_WARN("[THREADPOOL] Replaying a schedule recorded with {} workers and seed {} on {} workers and seed {}",
+                             config.replay->threadCount, config.replay->seed, threadCount, config.seed);
+
+                m_replaying = true;
+                m_replayRoutes.reserve(config.replay->records.size());
+                for (const ScheduleRecord &record : config.replay->records)
+                    if (record.worker < threadCount)
+                        m_replayRoutes.emplace(record.task, record.worker);
+            }
+        }
+
+        // Slots without a thread count as idle from the start, so utilization stays meaningful.
+        const int64_t now = SteadyNowNs();
+        for (size_t i = m_minWorkers; i < threadCount; ++i)
+            m_queues[i]->counters.idleSince.store(now, std::memory_order_relaxed);
+
+        {
+            std::lock_guard<std::mutex> lock(m_resizeMutex);
+            for (size_t i = 0; i < m_minWorkers; ++i)
+                SpawnWorker();
+        }
+
+        if (m_elastic)
+        {
+            // The timer thread doubles as the housekeeper that lets idle workers retire.
+            std::lock_guard<std::mutex> lock(m_timerMutex);
+            m_timerThread = std::thread(&ThreadPool::TimerLoop, this);
+        }
+    }
+
+    bool ThreadPool::SpawnWorker()
+    {
+        size_t index = m_activeWorkers.load(std::memory_order_acquire);
+        do
+        {
+            if (index >= m_queues.size())
+                return false;
+        } while (!m_activeWorkers.compare_exchange_weak(index, index + 1, std::memory_order_acq_rel));
+
+        // A worker that retired from this slot has already given it up and is on its way out.
+        if (m_workers[index].joinable())
+            m_workers[index].join();
+
+        try
+        {
+            m_workers[index] = std::thread(&ThreadPool::WorkerLoop, this, index);
+        }
+        catch (...)
+        {
+            // Nobody else changes the count meanwhile: growth holds m_resizeMutex and the slot has no thread to retire.
+            m_activeWorkers.fetch_sub(1, std::memory_order_acq_rel);
+            throw;
+        }
+        return true;
+    }
+
+    void ThreadPool::MaybeGrow()
+    {
+        // Shutdown() holds m_resizeMutex while it collects the workers; a stopping pool never grows.
+        if (!m_running.load(std::memory_order_acquire))
+            return;
+
+        // Parked workers will pick the work up; no point starting another one.
+        if (m_activeWorkers.load(std::memory_order_relaxed) >= m_queues.size() || m_idle.WaiterCount() != 0)
+            return;
+
+        const int64_t now = SteadyNowNs();
+        int64_t last = m_lastGrowNs.load(std::memory_order_relaxed);
+        if (now - last < std::chrono::nanoseconds(kGrowCooldown).count() ||
+            !m_lastGrowNs.compare_exchange_strong(last, now, std::memory_order_relaxed))
+            return;
+
+        size_t from = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_resizeMutex);
+            if (!m_running.load(std::memory_order_acquire))
+                return;
+
+            from = m_activeWorkers.load(std::memory_order_relaxed);
+            try
+            {
+                if (!SpawnWorker())
+                    return;
+            }
+            catch (const std::exception &e)
+            {
+                LOG_WARN("[THREADPOOL] Failed to start worker {}: {}", from, e.what());
+                return;
+            }
+        }
+
+        m_spawnedWorkers.fetch_add(1, std::memory_order_relaxed);
+        if (m_config.onResize)
+            m_config.onResize(from, from + 1);
+    }
+
+    bool ThreadPool::TryRetire(size_t index, int64_t idleSince)
+    {
+        if (index < m_minWorkers || SteadyNowNs() - idleSince < std::chrono::nanoseconds(m_config.idleRetireTime).count())
+            return false;
+
+        // Only the highest running worker may leave, which keeps the running slots contiguous.
+        size_t expected = index + 1;
+        if (!m_activeWorkers.compare_exchange_strong(expected, index, std::memory_order_acq_rel))
+            return false;
+
+        m_retiredWorkers.fetch_add(1, std::memory_order_relaxed);
+        if (m_config.onResize)
+            m_config.onResize(index + 1, index);
+        return true;
+    }
+
+    void ThreadPool::PlaceWorkers()
+    {
+        const size_t count = m_queues.size();
+
+        if (m_config.affinity != WorkerAffinity::None)
+        {
+            std::vector<CpuSlot> slots = ResolveNodes(m_config.cpus.empty() ? AllowedCpus() : m_config.cpus);
+            std::stable_sort(slots.begin(), slots.end(), [](const CpuSlot &a, const CpuSlot &b)
+                             { return a.node != b.node ? a.node < b.node : a.cpu < b.cpu; });
+
+            if (m_config.reservedCpus >= slots.size())
+            {
+                LOG_WARN("[THREADPOOL] {} reserved CPUs leave none for workers; ignoring the reservation", m_config.reservedCpus);
+            }
+            else
+            {
+                slots.erase(slots.begin(), slots.begin() + m_config.reservedCpus);
+            }
+
+            if (count > slots.size())
+                LOG_WARN("[THREADPOOL] {} workers share {} CPUs", count, slots.size());
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                WorkerQueue &queue = *m_queues[i];
+                const CpuSlot &slot = slots[i % slots.size()];
+                queue.node = slot.node;
+
+                if (m_config.affinity == WorkerAffinity::Cpu)
+                {
+                    queue.cpus = {slot.cpu};
+                }
+                else
+                {
+                    for (const CpuSlot &other : slots)
+                        if (other.node == slot.node)
+                            queue.cpus.push_back(other.cpu);
+                }
+            }
+        }
+
+        // Steal order: rotate from the next worker, same node first when NUMA-aware.
+        for (size_t i = 0; i < count; ++i)
+        {
+            WorkerQueue &queue = *m_queues[i];
+            queue.victims.clear();
+            queue.victims.reserve(count - 1);
+
+            for (size_t pass = 0; pass < 2; ++pass)
+            {
+                for (size_t offset = 1; offset < count; ++offset)
+                {
+                    const size_t victim = (i + offset) % count;
+                    const bool sameNode = !m_config.numaAwareStealing || m_queues[victim]->node == queue.node;
+                    if (sameNode == (pass == 0))
+                        queue.victims.push_back(victim);
+                }
+            }
+        }
+    }
+
+    void ThreadPool::ConfigureWorkerThread(size_t index) const
+    {
+        const WorkerQueue &queue = *m_queues[index];
+        std::string name;
+        if (!m_config.threadName.empty())
+        {
+            // Keep the index visible: the Linux kernel limits thread names to 15 characters.
+            const std::string suffix = "-" + std::to_string(index);
+            name = m_config.threadName.substr(0, suffix.size() < 15 ? 15 - suffix.size() : 0) + suffix;
+        }
+
+#if defined(_WIN32)
+        HANDLE thread = GetCurrentThread();
+
+        if (!name.empty())
+        {
+            const std::wstring wide(name.begin(), name.end());
+            SetThreadDescription(thread, wide.c_str());
+        }
+
+        if (!queue.cpus.empty())
+        {
+            DWORD_PTR mask = 0;
+            for (uint32_t cpu : queue.cpus)
+                if (cpu < sizeof(DWORD_PTR) * 8)
+                    mask |= DWORD_PTR(1) << cpu;
+            if (mask == 0 || SetThreadAffinityMask(thread, mask) == 0)
+                LOG_WARN("[THREADPOOL] Failed to set affinity of worker {}", index);
+        }
+
+        int priority = THREAD_PRIORITY_NORMAL;
+        switch (m_config.schedPolicy)
+        {
+        case WorkerSchedPolicy::Inherit:
+            return;
+        case WorkerSchedPolicy::Batch:
+            priority = THREAD_PRIORITY_BELOW_NORMAL;
+            break;
+        case WorkerSchedPolicy::Idle:
+            priority = THREAD_PRIORITY_IDLE;
+            break;
+        case WorkerSchedPolicy::Fifo:
+        case WorkerSchedPolicy::RoundRobin:
+            priority = THREAD_PRIORITY_HIGHEST;
+            break;
+        }
+        if (!SetThreadPriority(thread, priority))
+            LOG_WARN("[THREADPOOL] Failed to set priority of worker {}", index);
+#elif defined(__linux__)
+        if (!name.empty())
+        {
+            pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+        }
+
+        if (!queue.cpus.empty())
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (uint32_t cpu : queue.cpus)
+                if (cpu < CPU_SETSIZE)
+                    CPU_SET(cpu, &set);
+            if (sched_setaffinity(0, sizeof(set), &set) != 0)
+                LOG_WARN("[THREADPOOL] Failed to set affinity of worker {}", index);
+        }
+
+        int policy = SCHED_OTHER;
+        sched_param param{};
+        switch (m_config.schedPolicy)
+        {
+        case WorkerSchedPolicy::Inherit:
+            return;
+        case WorkerSchedPolicy::Batch:
+            policy = SCHED_BATCH;
+            break;
+        case WorkerSchedPolicy::Idle:
+            policy = SCHED_IDLE;
+            break;
+        case WorkerSchedPolicy::Fifo:
+            policy = SCHED_FIFO;
+            param.sched_priority = m_config.schedPriority;
+            break;
+        case WorkerSchedPolicy::RoundRobin:
+            policy = SCHED_RR;
+            param.sched_priority = m_config.schedPriority;
+            break;
+        }
+        if (const int error = pthread_setschedparam(pthread_self(), policy, &param); error != 0)
+            LOG_WARN("[THREADPOOL] Failed to set scheduling policy of worker {} (error {})", index, error);
+#else
+        (void)queue;
+        (void)name;
+#endif
     }
 
     ThreadPool::~ThreadPool()
@@ -21,54 +641,780 @@ namespace cp
 
     void ThreadPool::Shutdown()
     {
+        StopTimers();
+
+        // Stop accepting external submissions, then let the ones already past
+        // their check land before any worker is allowed to exit.
         m_running = false;
-        for (auto &cond : m_conditions)
-            cond.notify_all();
+        while (m_submitting.load() != 0)
+            std::this_thread::yield();
+        m_stopWorkers = true;
+        m_idle.NotifyAll();
 
-        for (auto &t : m_workers)
+        // Take the threads under the lock so no growth races with it, but join
+        // outside it: draining workers may still reach MaybeGrow().
+        std::vector<std::thread> workers;
+        {
+            std::lock_guard<std::mutex> lock(m_resizeMutex);
+            workers.resize(m_workers.size());
+            workers.swap(m_workers);
+        }
+        for (auto &t : workers)
             if (t.joinable())
                 t.join();
+
+        // Workers drain everything they can reach before exiting; anything
+        // left (e.g. submitted concurrently with shutdown) is released here.
+        for (auto &queue : m_queues)
+        {
+            for (size_t lane = 0; lane < kLaneCount; ++lane)
+            {
+                while (auto node = queue->deques[lane].Pop())
+                {
+                    (*node)->job.Reset();
+                    (*node)->token = {};
+                    LocalNodeCache<JobNode>().Recycle(*node);
+                }
+                while (JobNode *node = queue->inboxes[lane].PopFront())
+                {
+                    node->job.Reset();
+                    node->token = {};
+                    LocalNodeCache<JobNode>().Recycle(node);
+                }
+            }
+        }
     }
 
-    void ThreadPool::WorkerLoop(size_t index)
+    ThreadPool::SubmitScope::SubmitScope(ThreadPool &owner)
+        : pool(t_pool == &owner ? nullptr : &owner)
     {
-        while (m_running)
+        if (!pool)
+            return;
+
+        // Pairs with Shutdown(): either it sees this submission or this sees the pool stopped.
+        pool->m_submitting.fetch_add(1);
+        if (!pool->m_running.load())
         {
-            std::function<void()> task;
+            pool->m_submitting.fetch_sub(1, std::memory_order_release);
+            throw std::runtime_error("ThreadPool is shut down");
+        }
+    }
 
-            {
-                std::unique_lock<std::mutex> lock(m_mutexes[index]);
-                m_conditions[index].wait(lock, [&]
-                                         { return !m_queues[index].empty() || !m_running; });
+    ThreadPool::SubmitScope::~SubmitScope()
+    {
+        if (pool)
+            pool->m_submitting.fetch_sub(1, std::memory_order_release);
+    }
 
-                if (!m_running && m_queues[index].empty())
-                    return;
+    void ThreadPool::Enqueue(Job &&job, TaskPriority priority, CancellationToken token, TaskOptions::Clock::time_point deadline)
+    {
+        SubmitScope scope(*this);
+
+        JobNode *node = LocalNodeCache<JobNode>().Acquire();
+        node->job = std::move(job);
+        node->token = std::move(token);
+        node->deadlineNs = deadline == TaskOptions::Clock::time_point::max()
+                               ? 0
+                               : std::max<int64_t>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count());
+        if (m_elastic)
+            node->enqueuedNs = SteadyNowNs();
+        if (m_deterministic)
+            node->taskId = NextTaskId();
 
-                if (!m_queues[index].empty())
+        const size_t lane = static_cast<size_t>(priority);
+        WorkerQueue *queue = nullptr;
+        if (t_pool == this && (!m_replaying || HomeQueue(node->taskId) == t_workerIndex))
+        {
+            // Worker-local submission: lock-free push onto the owner's deque.
+            queue = m_queues[t_workerIndex].get();
+            queue->deques[lane].Push(node);
+        }
+        else
+        {
+            // Deterministic pools place by task id rather than by load; replays on the recorded worker.
+            queue = m_queues[m_deterministic ? HomeQueue(node->taskId) : SelectQueue()].get();
+            std::lock_guard<std::mutex> lock(queue->inboxMutex);
+            queue->inboxes[lane].PushBack(node);
+        }
+
+        // A replayed task may only be taken by its recorded worker, which has to be awake for it.
+        if (m_replaying)
+            m_idle.NotifyAll();
+        else
+            m_idle.NotifyOne();
+
+        if (m_elastic && queue->Depth() > m_config.growQueueDepth)
+            MaybeGrow();
+    }
+
+    uint64_t ThreadPool::TimerTick(std::chrono::steady_clock::time_point time) const
+    {
+        if (time <= m_startTime)
+            return 0;
+        return static_cast<uint64_t>((time - m_startTime) / kTimerTick);
+    }
+
+    void ThreadPool::AddTimer(std::unique_ptr<TimerEntry> entry, std::chrono::nanoseconds delay)
+    {
+        // Round the deadline up so timers never fire early.
+        const auto due = std::chrono::steady_clock::now() + std::max(delay, std::chrono::nanoseconds(0)) - m_startTime;
+        entry->deadline = static_cast<uint64_t>(std::chrono::ceil<std::chrono::milliseconds>(due) / kTimerTick);
+
+        std::lock_guard<std::mutex> lock(m_timerMutex);
+        if (m_timersStopped)
+            throw std::runtime_error("ThreadPool is shut down");
+
+        if (!m_timerThread.joinable())
+            m_timerThread = std::thread(&ThreadPool::TimerLoop, this);
+
+        TimerEntry *timer = entry.release();
+        m_timerWheel.Insert(timer);
+        if (timer->deadline < m_timerWake)
+        {
+            m_timerWake = timer->deadline;
+            m_timerCv.notify_one();
+        }
+    }
+
+    void ThreadPool::RunTimer(std::unique_ptr<TimerEntry> entry)
+    {
+        if (entry->token.IsCancelled())
+            return;
+
+        entry->job();
+
+        if (entry->period == 0 || entry->token.IsCancelled())
+            return;
+
+        std::lock_guard<std::mutex> lock(m_timerMutex);
+        if (m_timersStopped)
+            return;
+
+        // Fixed rate: next slot after the previous deadline, skipping periods missed by an overrun.
+        const uint64_t now = TimerTick(std::chrono::steady_clock::now());
+        uint64_t next = entry->deadline + entry->period;
+        if (next <= now)
+            next += ((now - next) / entry->period + 1) * entry->period;
+        entry->deadline = next;
+
+        TimerEntry *timer = entry.release();
+        m_timerWheel.Insert(timer);
+        if (timer->deadline < m_timerWake)
+        {
+            m_timerWake = timer->deadline;
+            m_timerCv.notify_one();
+        }
+    }
+
+    void ThreadPool::TimerLoop()
+    {
+        const uint64_t retireCheckTicks = std::max<uint64_t>(1, static_cast<uint64_t>(m_config.idleRetireTime / kTimerTick / 2));
+
+        std::unique_lock<std::mutex> lock(m_timerMutex);
+        while (!m_timersStopped)
+        {
+            const uint64_t now = TimerTick(std::chrono::steady_clock::now());
+
+            // Collect the due timers (in firing order) under the lock, enqueue them
+            // after releasing it: Enqueue() takes inbox locks and may grow the pool.
+            TimerEntry *due = nullptr;
+            TimerEntry **tail = &due;
+            m_timerWheel.Advance(now, [&tail](TimerEntry *timer)
+                                 {
+                                     timer->next = nullptr;
+                                     *tail = timer;
+                                     tail = &timer->next; });
+
+            if (due)
+            {
+                lock.unlock();
+                while (due)
                 {
-                    task = std::move(m_queues[index].front());
-                    m_queues[index].pop_front();
+                    std::unique_ptr<TimerEntry> entry(std::exchange(due, due->next));
+                    if (entry->token.IsCancelled())
+                        continue;
+
+                    const TaskPriority priority = entry->priority;
+                    Enqueue(Job([this, entry = std::move(entry)]() mutable
+                                { RunTimer(std::move(entry)); }),
+                            priority);
                 }
+                lock.lock();
             }
 
-            if (!task)
+            // Parked workers only notice their idle time when woken; nudge them so the highest can retire.
+            if (m_elastic && now >= m_nextRetireCheck)
             {
-                for (size_t i = 0; i < m_queues.size(); ++i)
+                m_nextRetireCheck = now + retireCheckTicks;
+                if (m_activeWorkers.load(std::memory_order_relaxed) > m_minWorkers)
+                    m_idle.NotifyAll();
+            }
+
+            m_timerWake = m_timerWheel.NextEventTick();
+            if (m_elastic)
+                m_timerWake = std::min(m_timerWake, m_nextRetireCheck);
+            if (m_timerWake == TimerWheel<TimerEntry>::kNever)
+                m_timerCv.wait(lock);
+            else
+                m_timerCv.wait_until(lock, m_startTime + kTimerTick * static_cast<int64_t>(m_timerWake));
+        }
+    }
+
+    void ThreadPool::StopTimers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_timerMutex);
+            if (m_timersStopped)
+                return;
+            m_timersStopped = true;
+        }
+        m_timerCv.notify_one();
+
+        if (m_timerThread.joinable())
+            m_timerThread.join();
+
+        std::lock_guard<std::mutex> lock(m_timerMutex);
+        m_timerWheel.Clear([](TimerEntry *timer)
+                           { delete timer; });
+    }
+
+    void ThreadPool::SubmitBatch(std::span<Job> jobs, TaskPriority priority)
+    {
+        if (!m_running.load(std::memory_order_acquire))
+            throw std::runtime_error("ThreadPool is shut down");
+
+        EnqueueBatch(
+            jobs.size(),
+            [](void *ctx, size_t index) -> Job
+            { return std::move(static_cast<Job *>(ctx)[index]); },
+            jobs.data(), priority);
+    }
+
+    void ThreadPool::EnqueueBatch(size_t count, JobFactory factory, void *context, TaskPriority priority)
+    {
+        if (count == 0)
+            return;
+
+        SubmitScope scope(*this);
+
+        if (m_deterministic)
+        {
+            // Every job needs its own id and placement; batching would route them by chunk.
+            for (size_t i = 0; i < count; ++i)
+                Enqueue(factory(context, i), priority);
+            return;
+        }
+
+        const size_t lane = static_cast<size_t>(priority);
+        NodeCache<JobNode> &cache = LocalNodeCache<JobNode>();
+        const int64_t enqueuedNs = m_elastic ? SteadyNowNs() : 0;
+
+        if (t_pool == this)
+        {
+            // Worker-local: everything onto the owner's deque; thieves spread it.
+            WorkStealingDeque<JobNode *> &deque = m_queues[t_workerIndex]->deques[lane];
+            for (size_t i = 0; i < count; ++i)
+            {
+                Job job = factory(context, i);
+                JobNode *node = cache.Acquire();
+                node->job = std::move(job);
+                node->enqueuedNs = enqueuedNs;
+                node->deadlineNs = 0;
+                deque.Push(node);
+            }
+        }
+        else
+        {
+            // One contiguous chunk per queue, linked outside the lock and spliced in with one acquisition.
+            const size_t queueCount = std::max<size_t>(1, m_activeWorkers.load(std::memory_order_relaxed));
+            const size_t targets = std::min(count, queueCount);
+            const size_t firstQueue = SelectQueue();
+
+            size_t next = 0;
+            for (size_t t = 0; t < targets; ++t)
+            {
+                const size_t end = count * (t + 1) / targets;
+
+                JobList chunk;
+                try
                 {
-                    if (i == index)
-                        continue;
-                    std::lock_guard<std::mutex> lock(m_mutexes[i]);
-                    if (!m_queues[i].empty())
+                    for (; next < end; ++next)
+                    {
+                        Job job = factory(context, next);
+                        JobNode *node = cache.Acquire();
+                        node->job = std::move(job);
+                        node->enqueuedNs = enqueuedNs;
+                        node->deadlineNs = 0;
+                        chunk.PushBack(node);
+                    }
+                }
+                catch (...)
+                {
+                    while (JobNode *node = chunk.PopFront())
                     {
-                        task = std::move(m_queues[i].back());
-                        m_queues[i].pop_back();
-                        break;
+                        node->job.Reset();
+                        cache.Recycle(node);
                     }
+                    m_idle.NotifyMany(std::min(next, queueCount));
+                    throw;
                 }
+
+                WorkerQueue &queue = *m_queues[(firstQueue + t) % queueCount];
+                std::lock_guard<std::mutex> lock(queue.inboxMutex);
+                queue.inboxes[lane].Splice(chunk);
             }
+        }
+
+        m_idle.NotifyMany(std::min(count, m_queues.size()));
+
+        if (m_elastic && count > m_config.growQueueDepth)
+            MaybeGrow();
+    }
+
+    size_t ThreadPool::SelectQueue() const
+    {
+        // Only running workers' queues; a slot retired meanwhile is still drained by thieves.
+        const size_t count = std::min(m_queues.size(), m_activeWorkers.load(std::memory_order_relaxed));
+        if (count <= 1)
+            return 0;
+
+        const uint64_t random = NextSubmitRandom();
+        const size_t first = t_submitCursor++ % count;
+        const size_t second = (first + 1 + static_cast<size_t>(random % (count - 1))) % count;
+
+        return m_queues[first]->Depth() <= m_queues[second]->Depth() ? first : second;
+    }
+
+    uint64_t ThreadPool::NextTaskId()
+    {
+        // Children are numbered per parent, so concurrent workers cannot swap each other's ids.
+        if (t_pool == this && t_taskId != 0)
+            return ChildTaskId(t_taskId, ++t_childIndex);
+        return ChildTaskId(m_rootTaskId, m_externalTasks.fetch_add(1, std::memory_order_relaxed) + 1);
+    }
+
+    size_t ThreadPool::HomeQueue(uint64_t taskId) const
+    {
+        if (m_replaying)
+        {
+            const auto route = m_replayRoutes.find(taskId);
+            if (route != m_replayRoutes.end())
+                return route->second;
+        }
+        return static_cast<size_t>(taskId % m_queues.size());
+    }
 
-            if (task)
-                task();
+    void ThreadPool::RecordTask(size_t index, const JobNode *node, size_t victim)
+    {
+        WorkerQueue &own = *m_queues[index];
+        std::lock_guard<std::mutex> lock(own.recordMutex);
+        own.records.push_back({node->taskId, static_cast<uint32_t>(index), static_cast<uint32_t>(victim)});
+    }
+
+    ScheduleLog ThreadPool::GetScheduleLog() const
+    {
+        ScheduleLog log;
+        log.seed = m_config.seed;
+        log.threadCount = m_queues.size();
+        if (!m_deterministic)
+            return log;
+
+        for (const auto &queue : m_queues)
+        {
+            std::lock_guard<std::mutex> lock(queue->recordMutex);
+            log.records.insert(log.records.end(), queue->records.begin(), queue->records.end());
         }
+        std::sort(log.records.begin(), log.records.end(), [](const ScheduleRecord &a, const ScheduleRecord &b)
+                  { return a.task < b.task; });
+        return log;
+    }
+
+    size_t ScheduleLog::StealCount() const
+    {
+        return static_cast<size_t>(std::count_if(records.begin(), records.end(), [](const ScheduleRecord &record)
+                                                 { return record.victim != record.worker; }));
+    }
+
+    void ScheduleLog::Write(std::ostream &out) const
+    {
+        out << "cp-schedule 1 " << seed << ' ' << threadCount << ' ' << records.size() << '\n';
+        for (const ScheduleRecord &record : records)
+            out << record.task << ' ' << record.worker << ' ' << record.victim << '\n';
+    }
+
+    ScheduleLog ScheduleLog::Read(std::istream &in)
+    {
+        std::string magic;
+        int version = 0;
+        size_t count = 0;
+        ScheduleLog log;
+        if (!(in >> magic >> version >> log.seed >> log.threadCount >> count) || magic != "cp-schedule" || version != 1)
+            throw std::runtime_error("Not a ThreadPool schedule log");
+
+        log.records.resize(count);
+        for (ScheduleRecord &record : log.records)
+            if (!(in >> record.task >> record.worker >> record.victim))
+                throw std::runtime_error("Truncated ThreadPool schedule log");
+        return log;
+    }
+
+    void ThreadPool::JobList::PushBack(JobNode *node)
+    {
+        node->next = nullptr;
+        if (tail)
+            tail->next = node;
+        else
+            head = node;
+        tail = node;
+        size.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    ThreadPool::JobNode *ThreadPool::JobList::PopFront()
+    {
+        JobNode *node = head;
+        if (!node)
+            return nullptr;
+
+        head = node->next;
+        if (!head)
+            tail = nullptr;
+        node->next = nullptr;
+        size.fetch_sub(1, std::memory_order_relaxed);
+        return node;
+    }
+
+    void ThreadPool::JobList::Splice(JobList &other)
+    {
+        if (!other.head)
+            return;
+
+        if (tail)
+            tail->next = other.head;
+        else
+            head = other.head;
+        tail = other.tail;
+        size.fetch_add(other.size.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        other.head = nullptr;
+        other.tail = nullptr;
+        other.size.store(0, std::memory_order_relaxed);
+    }
+
+    ThreadPool::JobNode *ThreadPool::FindWork(size_t index)
+    {
+        WorkerQueue &own = *m_queues[index];
+
+        // Aging: a local lower lane that has been passed over long enough gets one turn.
+        for (size_t lane = kLaneCount - 1; lane > 0; --lane)
+        {
+            if (own.starvation[lane] < kAgingInterval)
+                continue;
+
+            own.starvation[lane] = 0;
+            if (JobNode *node = TakeLocal(index, lane))
+            {
+                if (m_deterministic)
+                    RecordTask(index, node, index);
+                return node;
+            }
+        }
+
+        // A replay reproduces the recorded steals by routing; stealing live would diverge from it.
+        // Once shutting down, leftovers of exited workers must still be drained.
+        const bool maySteal = !m_replaying || !m_running.load(std::memory_order_relaxed);
+
+        // Lanes from HIGH to LOW, each one locally first and then stolen:
+        // HIGH work anywhere in the pool beats local lower-priority work.
+        for (size_t lane = 0; lane < kLaneCount; ++lane)
+        {
+            size_t victim = index;
+            JobNode *node = TakeLocal(index, lane);
+            if (!node && maySteal)
+            {
+                node = Steal(index, lane, &victim);
+                WorkerCounters::Add(node ? own.counters.stolen : own.counters.failedSteals);
+            }
+            if (!node)
+                continue;
+
+            if (m_deterministic)
+                RecordTask(index, node, victim);
+            own.starvation[lane] = 0;
+            for (size_t lower = lane + 1; lower < kLaneCount; ++lower)
+                if (!own.deques[lower].Empty() || own.inboxes[lower].size.load(std::memory_order_relaxed) > 0)
+                    own.starvation[lower]++;
+            return node;
+        }
+
+        return nullptr;
+    }
+
+    ThreadPool::JobNode *ThreadPool::TakeLocal(size_t index, size_t lane)
+    {
+        WorkerQueue &own = *m_queues[index];
+
+        if (auto node = own.deques[lane].Pop())
+            return *node;
+
+        if (own.inboxes[lane].size.load(std::memory_order_relaxed) == 0)
+            return nullptr;
+
+        std::lock_guard<std::mutex> lock(own.inboxMutex);
+        return own.inboxes[lane].PopFront();
+    }
+
+    ThreadPool::JobNode *ThreadPool::Steal(size_t index, size_t lane, size_t *victim)
+    {
+        const size_t count = m_queues.size();
+
+        if (index < count)
+        {
+            for (size_t candidate : m_queues[index]->victims)
+                if (JobNode *node = StealFrom(*m_queues[candidate], lane))
+                {
+                    if (victim)
+                        *victim = candidate;
+                    return node;
+                }
+            return nullptr;
+        }
+
+        const size_t start = static_cast<size_t>(NextSubmitRandom() % count);
+        for (size_t offset = 0; offset < count; ++offset)
+        {
+            const size_t candidate = (start + offset) % count;
+            if (JobNode *node = StealFrom(*m_queues[candidate], lane))
+            {
+                if (victim)
+                    *victim = candidate;
+                return node;
+            }
+        }
+        return nullptr;
+    }
+
+    ThreadPool::JobNode *ThreadPool::StealFrom(WorkerQueue &victim, size_t lane)
+    {
+        if (auto node = victim.deques[lane].Steal())
+            return *node;
+
+        if (victim.inboxes[lane].size.load(std::memory_order_relaxed) == 0)
+            return nullptr;
+
+        // Never block on a victim's inbox: the owner or a submitter holds it briefly.
+        // Inboxes stay FIFO for thieves too, like the steal end of the deques.
+        std::unique_lock<std::mutex> lock(victim.inboxMutex, std::try_to_lock);
+        if (lock.owns_lock())
+            return victim.inboxes[lane].PopFront();
+        return nullptr;
+    }
+
+    ThreadPool::JobNode *ThreadPool::StealAny(size_t index, TaskPriority lowest)
+    {
+        for (size_t lane = 0; lane <= static_cast<size_t>(lowest); ++lane)
+            if (JobNode *node = Steal(index, lane))
+                return node;
+        return nullptr;
+    }
+
+    bool ThreadPool::TryRunPendingTask(TaskPriority lowest)
+    {
+        // Deterministic pools keep every task on a worker, so the schedule log covers all of them.
+        if (m_deterministic && t_pool != this)
+            return false;
+
+        JobNode *node = (t_pool == this) ? FindWork(t_workerIndex) : StealAny(m_queues.size(), lowest);
+        if (!node)
+            return false;
+
+        RunNode(node);
+        return true;
+    }
+
+    void ThreadPool::RunNode(JobNode *node)
+    {
+        if (node->token.IsCancelled())
+        {
+            if (t_pool == this)
+                WorkerCounters::Add(m_queues[t_workerIndex]->counters.cancelled);
+            else
+                m_externalCancelled.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if (node->deadlineNs != 0 && SteadyNowNs() > node->deadlineNs)
+        {
+            if (t_pool == this)
+                WorkerCounters::Add(m_queues[t_workerIndex]->counters.expired);
+            else
+                m_externalExpired.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            // Counted here rather than at dequeue so dropped tasks only show up as cancelled/expired.
+            if (t_pool == this)
+                WorkerCounters::Add(m_queues[t_workerIndex]->counters.executed);
+
+            if (m_deterministic)
+            {
+                // Nested runs (a waiting task helping out) restore the outer task's numbering afterwards.
+                const uint64_t parentId = std::exchange(t_taskId, node->taskId);
+                const uint64_t parentChildren = std::exchange(t_childIndex, 0);
+                RunJob(node->job);
+                t_taskId = parentId;
+                t_childIndex = parentChildren;
+            }
+            else
+            {
+                RunJob(node->job);
+            }
+        }
+
+        // Dropped jobs are destroyed unrun, which releases their captures (and breaks their promise).
+        node->job.Reset();
+        node->token = {};
+        LocalNodeCache<JobNode>().Recycle(node);
+    }
+
+    ThreadPoolStats ThreadPool::GetStats() const
+    {
+        const int64_t now = SteadyNowNs();
+        const auto uptime = std::chrono::steady_clock::now() - m_startTime;
+
+        ThreadPoolStats stats;
+        stats.uptimeNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(uptime).count());
+        stats.workers.reserve(m_queues.size());
+        stats.activeWorkers = m_activeWorkers.load(std::memory_order_relaxed);
+        stats.spawned = m_spawnedWorkers.load(std::memory_order_relaxed);
+        stats.retired = m_retiredWorkers.load(std::memory_order_relaxed);
+
+        for (size_t index = 0; index < m_queues.size(); ++index)
+        {
+            const WorkerQueue *queue = m_queues[index].get();
+            const WorkerCounters &counters = queue->counters;
+
+            WorkerStats worker;
+            worker.active = index < stats.activeWorkers;
+            worker.executed = counters.executed.load(std::memory_order_relaxed);
+            worker.stolen = counters.stolen.load(std::memory_order_relaxed);
+            worker.failedSteals = counters.failedSteals.load(std::memory_order_relaxed);
+            worker.idleNs = counters.idleNs.load(std::memory_order_relaxed);
+            worker.cancelled = counters.cancelled.load(std::memory_order_relaxed);
+            worker.expired = counters.expired.load(std::memory_order_relaxed);
+
+            // Include the idle period the worker is currently in, if any.
+            const int64_t idleSince = counters.idleSince.load(std::memory_order_relaxed);
+            if (idleSince != 0 && now > idleSince)
+                worker.idleNs += static_cast<uint64_t>(now - idleSince);
+
+            worker.idleNs = std::min(worker.idleNs, stats.uptimeNs);
+            worker.busyNs = stats.uptimeNs - worker.idleNs;
+            worker.queueDepth = queue->Depth();
+
+            stats.total.executed += worker.executed;
+            stats.total.stolen += worker.stolen;
+            stats.total.failedSteals += worker.failedSteals;
+            stats.total.cancelled += worker.cancelled;
+            stats.total.expired += worker.expired;
+            stats.total.idleNs += worker.idleNs;
+            stats.total.busyNs += worker.busyNs;
+            stats.total.queueDepth += worker.queueDepth;
+            stats.workers.push_back(worker);
+        }
+
+        // Tasks dropped while non-worker threads helped (WaitUntil(), TryRunPendingTask()).
+        stats.total.cancelled += m_externalCancelled.load(std::memory_order_relaxed);
+        stats.total.expired += m_externalExpired.load(std::memory_order_relaxed);
+
+        return stats;
+    }
+
+    size_t ThreadPool::AutoGrain(size_t count) const
+    {
+        // Aim for ~8 pieces per thread: enough slack for stealing to balance
+        // uneven work without drowning small ranges in scheduling overhead.
+        const size_t pieces = std::max<size_t>(1, m_queues.size() * 8);
+        return std::max<size_t>(1, count / pieces);
+    }
+
+    void ThreadPool::WorkerLoop(size_t index)
+    {
+        t_pool = this;
+        t_workerIndex = index;
+        ConfigureWorkerThread(index);
+
+        uint32_t idleRounds = 0;
+        const uint32_t spinRounds = m_config.spinCount;
+        const uint32_t yieldRounds = spinRounds + m_config.yieldCount;
+
+        // Idle time is sampled only on busy/idle transitions, never per task.
+        // A respawned slot continues the idle period its previous worker retired in.
+        WorkerCounters &counters = m_queues[index]->counters;
+        int64_t idleSince = counters.idleSince.load(std::memory_order_relaxed);
+        const int64_t startedAt = SteadyNowNs();
+        const int64_t growLatencyNs = std::chrono::nanoseconds(m_config.growLatency).count();
+        auto endIdle = [&]
+        {
+            if (idleSince == 0)
+                return;
+            WorkerCounters::Add(counters.idleNs, static_cast<uint64_t>(std::max<int64_t>(0, SteadyNowNs() - idleSince)));
+            counters.idleSince.store(0, std::memory_order_relaxed);
+            idleSince = 0;
+        };
+
+        while (true)
+        {
+            if (JobNode *node = FindWork(index))
+            {
+                endIdle();
+                idleRounds = 0;
+                if (m_elastic && m_running && SteadyNowNs() - node->enqueuedNs > growLatencyNs)
+                    MaybeGrow();
+                RunNode(node);
+                continue;
+            }
+
+            if (idleSince == 0)
+            {
+                idleSince = SteadyNowNs();
+                counters.idleSince.store(idleSince, std::memory_order_relaxed);
+            }
+
+            // Spin, then yield: cheap re-polls that catch bursts without a futex round trip.
+            if (idleRounds < yieldRounds && m_running)
+            {
+                if (idleRounds++ < spinRounds)
+                    CpuRelax();
+                else
+                    std::this_thread::yield();
+                continue;
+            }
+
+            // Retiring keeps counters.idleSince set, so the slot's inactive time counts as idle.
+            if (m_elastic && m_running && TryRetire(index, std::max(idleSince, startedAt)))
+                break;
+
+            // Park. Re-check after announcing ourselves so a concurrent submit cannot be missed.
+            const EventCount::Key key = m_idle.PrepareWait();
+            if (JobNode *node = FindWork(index))
+            {
+                m_idle.CancelWait();
+                endIdle();
+                idleRounds = 0;
+                RunNode(node);
+                continue;
+            }
+
+            if (m_stopWorkers.load(std::memory_order_acquire))
+            {
+                // Own queues are empty: everything reachable has been drained.
+                m_idle.CancelWait();
+                endIdle();
+                break;
+            }
+
+            m_idle.Wait(key);
+            idleRounds = 0;
+        }
+
+        t_pool = nullptr;
     }
-} // namespace cp
\ No newline at end of file
+} // namespace cp
@@ -1,5 +1,6 @@
 #include "cp_framework/vulkan/stagingRing.hpp"
 #include "cp_framework/debug/debug.hpp"
+#include "cp_framework/threading/threadPool.hpp"
 
 namespace cp::vulkan
 {
@@ -60,13 +61,19 @@ namespace cp::vulkan
         return (v + (align - 1)) & ~(align - 1);
     }
 
-    void StagingRing::SubmitAndTrack(UploadHandle handle, VkDeviceSize offset, VkDeviceSize size)
+    void StagingRing::SubmitAndTrack(UploadHandle handle, VkDeviceSize offset, VkDeviceSize size,
+                                     std::function<void()> onComplete)
     {
         if (!handle.valid())
+        {
+            if (onComplete)
+                onComplete();
             return;
+        }
         Pending p;
         p.handle = handle;
         p.offsetEnd = (offset + size) % totalSize;
+        p.onComplete = std::move(onComplete);
         {
             std::lock_guard<std::mutex> lk(queueMutex);
             pending.push(std::move(p));
@@ -123,12 +130,16 @@ namespace cp::vulkan
         cv.notify_one();
         if (janitor.joinable())
             janitor.join();
-        // cleanup any remaining pending handles
-        std::lock_guard<std::mutex> lk(queueMutex);
-        while (!pending.empty())
+        // cleanup any remaining pending handles (outside the lock: callbacks may resume coroutines)
+        std::queue<Pending> remaining;
+        {
+            std::lock_guard<std::mutex> lk(queueMutex);
+            remaining.swap(pending);
+        }
+        while (!remaining.empty())
         {
-            auto p = pending.front();
-            pending.pop();
+            Pending p = std::move(remaining.front());
+            remaining.pop();
             if (p.handle.valid())
             {
                 if (p.handle.device && p.handle.fence)
@@ -141,6 +152,8 @@ namespace cp::vulkan
                     vkFreeCommandBuffers(p.handle.device, p.handle.pool, 1, &p.handle.cmd);
                 }
             }
+            if (p.onComplete)
+                p.onComplete();
         }
     }
 
@@ -155,7 +168,7 @@ namespace cp::vulkan
                         { return !pending.empty() || !running.load(); });
                 if (!running.load() && pending.empty())
                     break;
-                item = pending.front();
+                item = std::move(pending.front());
                 pending.pop();
             }
 
@@ -177,6 +190,29 @@ namespace cp::vulkan
                 std::lock_guard<std::mutex> lk(commitMutex);
                 tail = item.offsetEnd;
             }
+
+            if (item.onComplete)
+                item.onComplete();
         }
     }
+
+    void StagingRing::UploadAwaiter::await_suspend(std::coroutine_handle<> awaiting)
+    {
+        m_ring.SubmitAndTrack(m_handle, m_offset, m_size, [awaiting, pool = m_resumeOn]
+                              {
+                                  if (pool)
+                                  {
+                                      try
+                                      {
+                                          pool->Dispatch(TaskPriority::NORMAL, [awaiting]
+                                                         { awaiting.resume(); });
+                                          return;
+                                      }
+                                      catch (const std::runtime_error &)
+                                      {
+                                          // Pool already shut down: continue on this thread instead.
+                                      }
+                                  }
+                                  awaiting.resume(); });
+    }
 }
\ No newline at end of file
@@ -0,0 +1,136 @@
+/**
+ * @file baselinePool.hpp
+ * @brief The ThreadPool the work-stealing pool replaced, kept as a benchmark baseline.
+ *
+ * One mutex-guarded std::deque and condition variable per worker, tasks
+ * wrapped in std::function around a shared packaged_task, and a queue picked
+ * at random per submission. A worker sleeps on its own queue and only scans
+ * the others once woken. The one change from the original is a thread-local
+ * RNG: the shared one raced as soon as two threads submitted.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <cp_framework/threading/threadPool.hpp>
+
+namespace cp::bench
+{
+    class BaselinePool
+    {
+    public:
+        explicit BaselinePool(size_t threadCount)
+            : m_queues(threadCount),
+              m_mutexes(threadCount),
+              m_conditions(threadCount),
+              m_running(true),
+              m_dist(0, threadCount - 1)
+        {
+            for (size_t i = 0; i < threadCount; ++i)
+                m_workers.emplace_back(&BaselinePool::WorkerLoop, this, i);
+        }
+
+        ~BaselinePool()
+        {
+            m_running = false;
+            for (auto &cond : m_conditions)
+                cond.notify_all();
+
+            for (auto &t : m_workers)
+                if (t.joinable())
+                    t.join();
+        }
+
+        BaselinePool(const BaselinePool &) = delete;
+        BaselinePool &operator=(const BaselinePool &) = delete;
+
+        template <typename Func, typename... Args>
+        auto Submit(TaskPriority priority, Func &&f, Args &&...args)
+            -> std::future<decltype(f(args...))>
+        {
+            using ReturnType = decltype(f(args...));
+
+            if (!m_running.load(std::memory_order_acquire))
+                throw std::runtime_error("ThreadPool is shut down");
+
+            auto task = std::make_shared<std::packaged_task<ReturnType()>>(
+                std::bind(std::forward<Func>(f), std::forward<Args>(args)...));
+            std::future<ReturnType> future = task->get_future();
+
+            thread_local std::mt19937 rng{std::random_device{}()};
+            size_t idx = m_dist(rng);
+            {
+                std::lock_guard<std::mutex> lock(m_mutexes[idx]);
+                if (priority == TaskPriority::HIGH)
+                    m_queues[idx].emplace_front([task]
+                                                { (*task)(); });
+                else
+                    m_queues[idx].emplace_back([task]
+                                               { (*task)(); });
+            }
+
+            m_conditions[idx].notify_one();
+            return future;
+        }
+
+    private:
+        void WorkerLoop(size_t index)
+        {
+            while (m_running)
+            {
+                std::function<void()> task;
+
+                {
+                    std::unique_lock<std::mutex> lock(m_mutexes[index]);
+                    m_conditions[index].wait(lock, [&]
+                                             { return !m_queues[index].empty() || !m_running; });
+
+                    if (!m_running && m_queues[index].empty())
+                        return;
+
+                    if (!m_queues[index].empty())
+                    {
+                        task = std::move(m_queues[index].front());
+                        m_queues[index].pop_front();
+                    }
+                }
+
+                if (!task)
+                {
+                    for (size_t i = 0; i < m_queues.size(); ++i)
+                    {
+                        if (i == index)
+                            continue;
+                        std::lock_guard<std::mutex> lock(m_mutexes[i]);
+                        if (!m_queues[i].empty())
+                        {
+                            task = std::move(m_queues[i].back());
+                            m_queues[i].pop_back();
+                            break;
+                        }
+                    }
+                }
+
+                if (task)
+                    task();
+            }
+        }
+
+        std::vector<std::deque<std::function<void()>>> m_queues; ///< Per-thread task queues.
+        std::vector<std::mutex> m_mutexes;                       ///< One mutex per queue.
+        std::vector<std::condition_variable> m_conditions;       ///< One condition variable per queue.
+        std::vector<std::thread> m_workers;                      ///< Worker thread handles.
+        std::atomic_bool m_running;                              ///< Indicates whether the pool accepts tasks.
+        std::uniform_int_distribution<size_t> m_dist;            ///< Distribution over worker index range.
+    };
+} // namespace cp::bench
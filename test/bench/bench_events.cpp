@@ -0,0 +1,177 @@
+/**
+ * @brief EventDispatcher throughput.
+ *
+ * - Emit(): events/sec with 1..N threads emitting the same type at once
+ *   (listener lists are read without locks).
+ * - QueueEvent(): ns per queued event, one and several producers.
+ * - DispatchQueued(): ns per event to drain a batch of mixed types.
+ * - Parallel listeners: DispatchQueued() with heavy listeners fanned out
+ *   to a ThreadPool against the same listeners run serially.
+ *
+ * Usage: bench_events [max threads]
+ */
+
+#include "benchmark.hpp"
+#include <cp_framework/events/events.hpp>
+#include <cp_framework/threading/threadPool.hpp>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+using namespace cp;
+using namespace cp::bench;
+
+namespace
+{
+    struct Small : Event
+    {
+        int value = 0;
+        explicit Small(int v = 0) : value(v) {}
+    };
+
+    struct Medium : Event
+    {
+        float data[12] = {};
+        explicit Medium(int v = 0) { data[0] = static_cast<float>(v); }
+    };
+
+    struct Heavy : Event
+    {
+        int value = 0;
+        explicit Heavy(int v = 0) : value(v) {}
+    };
+
+    template <typename Body>
+    double Concurrently(size_t threads, Body &&body)
+    {
+        return BestOf(3, [&]
+                      {
+                          std::vector<std::thread> workers;
+                          for (size_t t = 0; t < threads; ++t)
+                              workers.emplace_back(body);
+                          for (std::thread &worker : workers)
+                              worker.join(); });
+    }
+
+    void EmitScaling(size_t maxThreads)
+    {
+        constexpr int kEmits = 1'000'000;
+        EventDispatcher dispatcher;
+        std::atomic<int64_t> sum{0};
+        for (int i = 0; i < 4; ++i)
+            dispatcher.Subscribe<Small>([&sum](const Small &e)
+                                        { sum.fetch_add(e.value, std::memory_order_relaxed); });
+
+        std::printf("%8s %16s\n", "threads", "emits/s");
+        for (size_t threads : ThreadCounts(maxThreads))
+        {
+            const double seconds = Concurrently(threads, [&]
+                                                {
+                                                    for (int i = 0; i < kEmits; ++i)
+                                                        dispatcher.Emit(Small(i)); });
+            std::printf("%8zu %16.0f\n", threads, static_cast<double>(kEmits * threads) / seconds);
+        }
+    }
+
+    void QueueCost(size_t maxThreads)
+    {
+        constexpr int kEvents = 500'000;
+        EventDispatcher dispatcher;
+        dispatcher.Subscribe<Small>([](const Small &) {});
+
+        std::printf("\n%8s %16s %16s\n", "producers", "queue ns/event", "drain ns/event");
+        for (size_t threads : ThreadCounts(std::min<size_t>(maxThreads, 8)))
+        {
+            double drain = 0.0;
+            const double queue = BestOf(3, [&]
+                                        {
+                                            std::vector<std::thread> producers;
+                                            for (size_t t = 0; t < threads; ++t)
+                                                producers.emplace_back([&]
+                                                                       {
+                                                                           for (int i = 0; i < kEvents; ++i)
+                                                                               dispatcher.QueueEvent<Small>(i); });
+                                            for (std::thread &producer : producers)
+                                                producer.join();
+
+                                            // Not part of the queue time; keeps the ring from overflowing.
+                                            const auto start = Clock::now();
+                                            dispatcher.DispatchQueued();
+                                            drain = SecondsSince(start); });
+            const double events = static_cast<double>(kEvents * threads);
+            std::printf("%8zu %16.1f %16.1f\n", threads, (queue - drain) * 1e9 / events, drain * 1e9 / events);
+        }
+    }
+
+    void MixedDrain()
+    {
+        constexpr int kEvents = 300'000;
+        EventDispatcher dispatcher(64u << 20);
+        std::atomic<int64_t> sum{0};
+        dispatcher.Subscribe<Small>([&sum](const Small &e)
+                                    { sum.fetch_add(e.value, std::memory_order_relaxed); });
+        dispatcher.Subscribe<Medium>([&sum](const Medium &e)
+                                     { sum.fetch_add(static_cast<int64_t>(e.data[0]), std::memory_order_relaxed); });
+
+        double drain = 1e300;
+        for (int repeat = 0; repeat < 3; ++repeat)
+        {
+            for (int i = 0; i < kEvents; ++i)
+            {
+                if (i & 1)
+                    dispatcher.QueueEvent<Medium>(i);
+                else
+                    dispatcher.QueueEvent<Small>(i);
+            }
+            const auto start = Clock::now();
+            dispatcher.DispatchQueued();
+            drain = std::min(drain, SecondsSince(start));
+        }
+        std::printf("\nmixed-type batch drain: %.1f ns/event\n", drain * 1e9 / kEvents);
+    }
+
+    void FanOut(size_t threads)
+    {
+        constexpr int kListeners = 64;
+        constexpr int kEvents = 200;
+        std::atomic<double> sink{0.0};
+        const auto work = [&sink](const Heavy &e)
+        {
+            double x = e.value;
+            for (int i = 0; i < 2000; ++i)
+                x = std::sqrt(x + i);
+            sink.store(x, std::memory_order_relaxed);
+        };
+
+        const auto measure = [&](ListenerExecution execution, ThreadPool *pool)
+        {
+            EventDispatcher dispatcher;
+            dispatcher.SetThreadPool(pool);
+            for (int l = 0; l < kListeners; ++l)
+                dispatcher.Subscribe<Heavy>(work, 0, execution);
+            const double seconds = BestOf(3, [&]
+                                          {
+                                              for (int i = 0; i < kEvents; ++i)
+                                                  dispatcher.QueueEvent<Heavy>(i);
+                                              dispatcher.DispatchQueued(); });
+            dispatcher.SetThreadPool(nullptr);
+            return seconds;
+        };
+
+        ThreadPool pool(threads);
+        const double serial = measure(ListenerExecution::Serial, nullptr);
+        const double parallel = measure(ListenerExecution::Parallel, &pool);
+        std::printf("\nfan-out of %d listeners x %d events: serial %.2fms, parallel %.2fms (%.2fx, %zu threads)\n",
+                    kListeners, kEvents, serial * 1e3, parallel * 1e3, serial / parallel, threads);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const size_t maxThreads = MaxThreads(argc, argv);
+    EmitScaling(maxThreads);
+    QueueCost(maxThreads);
+    MixedDrain();
+    FanOut(maxThreads);
+    return 0;
+}
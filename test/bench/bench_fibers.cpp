@@ -0,0 +1,51 @@
+/**
+ * @brief FiberScheduler context-switch cost.
+ *
+ * - Run(): launch and finish an empty fiber job (one switch in and out).
+ * - Ping-pong: a parent suspends on a child's counter and is resumed by it,
+ *   reported per WaitForCounter() round trip.
+ *
+ * Usage: bench_fibers [threads]
+ */
+
+#include "benchmark.hpp"
+#include <cp_framework/threading/fiberScheduler.hpp>
+#include <atomic>
+
+using namespace cp;
+using namespace cp::bench;
+
+int main(int argc, char **argv)
+{
+    const size_t threads = MaxThreads(argc, argv);
+    ThreadPool pool(threads);
+    FiberScheduler fibers(pool);
+
+    constexpr int kJobs = 200000;
+    const double launch = BestOf(3, [&]
+                                 {
+                                     JobCounter counter;
+                                     for (int i = 0; i < kJobs; ++i)
+                                         fibers.Run([] {}, &counter);
+                                     fibers.WaitForCounter(counter); });
+    std::printf("fiber launch+finish: %.1f ns/job (%zu threads)\n", launch * 1e9 / kJobs, threads);
+
+    constexpr int kRounds = 20000;
+    const uint64_t switchesBefore = fibers.GetSwitchCount();
+    const double pingPong = BestOf(3, [&]
+                                   {
+                                       JobCounter done;
+                                       fibers.Run([&]
+                                                  {
+                                                      for (int i = 0; i < kRounds; ++i)
+                                                      {
+                                                          JobCounter child;
+                                                          fibers.Run([] {}, &child);
+                                                          fibers.WaitForCounter(child);
+                                                      } },
+                                                  &done);
+                                       fibers.WaitForCounter(done); });
+    std::printf("suspend/resume round trip: %.1f ns (%llu switches total)\n", pingPong * 1e9 / kRounds,
+                static_cast<unsigned long long>(fibers.GetSwitchCount() - switchesBefore));
+    return 0;
+}
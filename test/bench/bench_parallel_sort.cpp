@@ -0,0 +1,56 @@
+/**
+ * @brief parallel::Sort() against std::sort.
+ *
+ * Sorts random 32-bit integers (radix path) and random doubles (merge path)
+ * from 1K up to 10M elements; pass a larger limit, e.g. 100000000, to go
+ * further.
+ *
+ * Usage: bench_parallel_sort [max elements] [threads]
+ */
+
+#include "benchmark.hpp"
+#include <cp_framework/threading/parallelAlgorithms.hpp>
+#include <random>
+
+using namespace cp;
+using namespace cp::bench;
+
+namespace
+{
+    template <typename T, typename Generate>
+    void Compare(ThreadPool &pool, const char *name, size_t maxElements, Generate generate)
+    {
+        std::printf("%-8s %12s %12s %12s %8s\n", name, "elements", "std::sort", "parallel", "speedup");
+        std::mt19937_64 rng(42);
+        for (size_t n = 1000; n <= maxElements; n *= 10)
+        {
+            std::vector<T> input(n);
+            for (T &value : input)
+                value = generate(rng);
+
+            std::vector<T> data;
+            const int repeats = n >= 10'000'000 ? 1 : 3;
+            const double serial = BestOf(repeats, [&]
+                                         {
+                                             data = input;
+                                             std::sort(data.begin(), data.end()); });
+            const double parallel = BestOf(repeats, [&]
+                                           {
+                                               data = input;
+                                               parallel::Sort(pool, data.begin(), data.end()); });
+            std::printf("%-8s %12zu %10.2fms %10.2fms %7.2fx\n", "", n, serial * 1e3, parallel * 1e3, serial / parallel);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const size_t maxElements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+    ThreadPool pool(MaxThreads(argc - 1, argv + 1));
+
+    Compare<uint32_t>(pool, "uint32", maxElements, [](std::mt19937_64 &rng)
+                      { return static_cast<uint32_t>(rng()); });
+    Compare<double>(pool, "double", maxElements, [](std::mt19937_64 &rng)
+                    { return std::uniform_real_distribution<double>(-1e6, 1e6)(rng); });
+    return 0;
+}
@@ -0,0 +1,172 @@
+/**
+ * @brief ThreadPool throughput and latency against the mutex + std::deque pool it replaced.
+ *
+ * - Tasks/sec of tiny tasks at 1..N threads, submitted from outside the pool
+ *   and from inside it (fork from a task): the baseline pool's Submit()
+ *   against ThreadPool's Submit() and Dispatch().
+ * - Submit throughput with several producer threads.
+ * - Submit-to-start latency percentiles, with the workers idle between tasks.
+ *
+ * Every run waits for its tasks by polling a counter, so neither pool's
+ * helping waits skew the comparison.
+ *
+ * Usage: bench_thread_pool [max threads]  (hardware concurrency, at most 64, by default)
+ */
+
+#include "baselinePool.hpp"
+#include "benchmark.hpp"
+#include <cp_framework/threading/threadPool.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace cp;
+using namespace cp::bench;
+
+namespace
+{
+    constexpr size_t kTasks = 1'000'000;
+
+    void WaitFor(const std::atomic<size_t> &done, size_t count)
+    {
+        while (done.load(std::memory_order_acquire) != count)
+            std::this_thread::yield();
+    }
+
+    /// Posts through ThreadPool::Dispatch().
+    struct Dispatched
+    {
+        template <typename Func>
+        void operator()(ThreadPool &pool, TaskPriority priority, Func &&f) const
+        {
+            pool.Dispatch(priority, std::forward<Func>(f));
+        }
+    };
+
+    /// Posts through Submit(), dropping the future; works for either pool.
+    struct Submitted
+    {
+        template <typename Pool, typename Func>
+        void operator()(Pool &pool, TaskPriority priority, Func &&f) const
+        {
+            (void)pool.Submit(priority, std::forward<Func>(f));
+        }
+    };
+
+    template <typename Pool, typename Post>
+    double ExternalTasksPerSecond(Pool &pool, Post post)
+    {
+        std::atomic<size_t> done{0};
+        const double seconds = BestOf(3, [&]
+                                      {
+                                          done.store(0);
+                                          for (size_t i = 0; i < kTasks; ++i)
+                                              post(pool, TaskPriority::NORMAL, [&done]
+                                                   { done.fetch_add(1, std::memory_order_relaxed); });
+                                          WaitFor(done, kTasks); });
+        return static_cast<double>(kTasks) / seconds;
+    }
+
+    template <typename Pool, typename Post>
+    double InternalTasksPerSecond(Pool &pool, Post post)
+    {
+        std::atomic<size_t> done{0};
+        const double seconds = BestOf(3, [&]
+                                      {
+                                          done.store(0);
+                                          // Spawned from a worker: the new pool pushes to that worker's deque.
+                                          post(pool, TaskPriority::NORMAL, [&]
+                                               {
+                                                   for (size_t i = 0; i < kTasks; ++i)
+                                                       post(pool, TaskPriority::NORMAL, [&done]
+                                                            { done.fetch_add(1, std::memory_order_relaxed); }); });
+                                          WaitFor(done, kTasks); });
+        return static_cast<double>(kTasks) / seconds;
+    }
+
+    template <typename Pool, typename Post>
+    double ProducerSubmitsPerSecond(Pool &pool, Post post, size_t producers)
+    {
+        std::atomic<size_t> done{0};
+        const size_t perProducer = kTasks / producers;
+        const double seconds = BestOf(3, [&]
+                                      {
+                                          done.store(0);
+                                          std::vector<std::thread> threads;
+                                          for (size_t p = 0; p < producers; ++p)
+                                              threads.emplace_back([&]
+                                                                   {
+                                                                       for (size_t i = 0; i < perProducer; ++i)
+                                                                           post(pool, TaskPriority::NORMAL, [&done]
+                                                                                { done.fetch_add(1, std::memory_order_relaxed); }); });
+                                          for (std::thread &thread : threads)
+                                              thread.join();
+                                          WaitFor(done, perProducer * producers); });
+        return static_cast<double>(perProducer * producers) / seconds;
+    }
+
+    template <typename Pool, typename Post>
+    void SubmitLatency(const char *name, Pool &pool, Post post)
+    {
+        constexpr size_t kSamples = 20000;
+        std::vector<int64_t> samples;
+        samples.reserve(kSamples);
+        for (size_t i = 0; i < kSamples; ++i)
+        {
+            std::atomic<int64_t> started{0};
+            const auto submitted = Clock::now();
+            post(pool, TaskPriority::HIGH, [&started]
+                 { started.store(Clock::now().time_since_epoch().count(), std::memory_order_release); });
+            while (started.load(std::memory_order_acquire) == 0)
+                std::this_thread::yield();
+            samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                  Clock::duration(started.load()) - submitted.time_since_epoch())
+                                  .count());
+
+            // Let the workers go idle again every few samples so parking shows up too.
+            if (i % 64 == 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        std::printf("%-10s submit->start latency: p50 %lld ns, p99 %lld ns, p99.9 %lld ns\n", name,
+                    static_cast<long long>(Percentile(samples, 0.50)),
+                    static_cast<long long>(Percentile(samples, 0.99)),
+                    static_cast<long long>(Percentile(samples, 0.999)));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const size_t maxThreads = MaxThreads(argc, argv);
+
+    std::printf("%8s %16s %16s %16s %16s %16s\n", "threads",
+                "baseline ext/s", "submit ext/s", "dispatch ext/s", "baseline int/s", "dispatch int/s");
+    for (size_t threads : ThreadCounts(maxThreads))
+    {
+        double baselineExternal, baselineInternal;
+        {
+            BaselinePool baseline(threads);
+            baselineExternal = ExternalTasksPerSecond(baseline, Submitted{});
+            baselineInternal = InternalTasksPerSecond(baseline, Submitted{});
+        }
+        ThreadPool pool(threads);
+        const double submitExternal = ExternalTasksPerSecond(pool, Submitted{});
+        const double dispatchExternal = ExternalTasksPerSecond(pool, Dispatched{});
+        const double dispatchInternal = InternalTasksPerSecond(pool, Dispatched{});
+        std::printf("%8zu %16.0f %16.0f %16.0f %16.0f %16.0f\n", threads,
+                    baselineExternal, submitExternal, dispatchExternal, baselineInternal, dispatchInternal);
+    }
+
+    BaselinePool baseline(maxThreads);
+    ThreadPool pool(maxThreads);
+    std::printf("\n%8s %16s %16s\n", "producers", "baseline/s", "dispatch/s");
+    for (size_t producers : ThreadCounts(maxThreads))
+        std::printf("%8zu %16.0f %16.0f\n", producers,
+                    ProducerSubmitsPerSecond(baseline, Submitted{}, producers),
+                    ProducerSubmitsPerSecond(pool, Dispatched{}, producers));
+
+    std::printf("\n");
+    SubmitLatency("baseline", baseline, Submitted{});
+    SubmitLatency("ThreadPool", pool, Dispatched{});
+    return 0;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file benchmark.hpp
+ * @brief Timing helpers shared by the microbenchmarks.
+ *
+ * The benchmarks are plain executables printing one line per measurement;
+ * they are built with -DBUILD_BENCHMARKS=ON and never run by CTest. Build
+ * them in Release: the numbers are meaningless under a debug build or a
+ * sanitizer.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace cp::bench
+{
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Seconds elapsed since @p start.
+     */
+    inline double SecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    /**
+     * @brief Runs @p body @p repeats times and returns the fastest run in seconds.
+     */
+    template <typename Body>
+    double BestOf(int repeats, Body &&body)
+    {
+        double best = 1e300;
+        for (int i = 0; i < repeats; ++i)
+        {
+            const auto start = Clock::now();
+            body();
+            best = std::min(best, SecondsSince(start));
+        }
+        return best;
+    }
+
+    /**
+     * @brief Returns the @p fraction quantile of @p samples (sorted in place).
+     */
+    template <typename T>
+    T Percentile(std::vector<T> &samples, double fraction)
+    {
+        if (samples.empty())
+            return T{};
+        std::sort(samples.begin(), samples.end());
+        const size_t index = std::min(samples.size() - 1, static_cast<size_t>(fraction * static_cast<double>(samples.size())));
+        return samples[index];
+    }
+
+    /**
+     * @brief Largest thread count to measure: argv[1] if given, else the hardware concurrency.
+     */
+    inline size_t MaxThreads(int argc, char **argv, size_t cap = 64)
+    {
+        if (argc > 1)
+            return std::max<size_t>(1, std::strtoull(argv[1], nullptr, 10));
+        return std::min<size_t>(cap, std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    /**
+     * @brief Thread counts 1, 2, 4, ... up to @p max (always including @p max).
+     */
+    inline std::vector<size_t> ThreadCounts(size_t max)
+    {
+        std::vector<size_t> counts;
+        for (size_t count = 1; count < max; count *= 2)
+            counts.push_back(count);
+        counts.push_back(max);
+        return counts;
+    }
+} // namespace cp::bench
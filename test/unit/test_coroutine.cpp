@@ -0,0 +1,154 @@
+#include "testing.hpp"
+#include <cp_framework/filesystem/filesystem.hpp>
+#include <cp_framework/threading/coroutine.hpp>
+#include <cp_framework/threading/threadPool.hpp>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace cp;
+
+namespace
+{
+    Task<int> Leaf(ThreadPool &pool, int value)
+    {
+        co_await pool.Schedule();
+        co_return value;
+    }
+
+    Task<int> Failing(ThreadPool &pool)
+    {
+        co_await pool.Schedule();
+        throw std::runtime_error("leaf failed");
+    }
+
+    Task<int> Sum(ThreadPool &pool)
+    {
+        const int a = co_await Leaf(pool, 20);
+        const int b = co_await Leaf(pool, 22);
+        co_return a + b;
+    }
+
+    Task<std::string> Describe(ThreadPool &pool)
+    {
+        co_return std::to_string(co_await Sum(pool));
+    }
+
+    Task<int> PassesErrorsThrough(ThreadPool &pool)
+    {
+        co_return co_await Failing(pool) + 1;
+    }
+
+    Task<int> Recovers(ThreadPool &pool)
+    {
+        try
+        {
+            co_await Failing(pool);
+        }
+        catch (const std::runtime_error &)
+        {
+            co_return -1;
+        }
+        co_return 0;
+    }
+
+    Task<> RecordThread(ThreadPool &pool, std::thread::id &before, std::thread::id &after)
+    {
+        before = std::this_thread::get_id();
+        co_await pool.Schedule(TaskPriority::HIGH);
+        after = std::this_thread::get_id();
+    }
+
+    Task<int> AwaitEmpty()
+    {
+        Task<int> empty;
+        co_return co_await empty;
+    }
+
+    Task<filesystem::FileBytes> ReadOnWorker(ThreadPool &pool, file_path path, std::thread::id &reader)
+    {
+        filesystem::FileBytes file = co_await filesystem::ReadBytesAsync(pool, std::move(path));
+        reader = std::this_thread::get_id();
+        co_return file;
+    }
+}
+
+CP_TEST(ValuesPropagateThroughNestedAwaits)
+{
+    ThreadPool pool(4);
+    CP_CHECK(SyncWait(pool, Describe(pool)) == "42");
+}
+
+CP_TEST(ExceptionsPropagateThroughNestedAwaits)
+{
+    ThreadPool pool(4);
+    CP_CHECK_THROWS(SyncWait(pool, PassesErrorsThrough(pool)), std::runtime_error);
+    CP_CHECK(SyncWait(pool, Recovers(pool)) == -1);
+}
+
+// Non-worker callers help with pool tasks while waiting; many at once must not deadlock.
+CP_TEST(SyncWaitFromNonWorkerThreads)
+{
+    ThreadPool pool(2);
+    std::vector<int> results(8, 0);
+    std::vector<std::thread> callers;
+    for (size_t i = 0; i < results.size(); ++i)
+        callers.emplace_back([&, i]
+                             { results[i] = SyncWait(pool, Sum(pool)); });
+    for (std::thread &caller : callers)
+        caller.join();
+
+    bool all = true;
+    for (int result : results)
+        all &= result == 42;
+    CP_CHECK(all);
+}
+
+// Started by hand and polled, so the caller cannot pick up the resumption itself as SyncWait() may.
+CP_TEST(ScheduleResumesOnAWorker)
+{
+    ThreadPool pool(2);
+    std::thread::id before, after;
+    Task<> task = RecordThread(pool, before, after);
+    task.Start();
+    CP_CHECK(testing::Eventually([&]
+                                 { return task.IsDone(); }));
+    CP_CHECK(before == std::this_thread::get_id());
+    CP_CHECK(after != std::thread::id());
+    CP_CHECK(after != before);
+}
+
+CP_TEST(AwaitingAnEmptyTaskThrows)
+{
+    ThreadPool pool(1);
+    CP_CHECK_THROWS(SyncWait(pool, AwaitEmpty()), std::invalid_argument);
+    CP_CHECK_THROWS(SyncWait(pool, Task<int>()), std::invalid_argument);
+}
+
+CP_TEST(ReadBytesAsyncReadsOnAWorker)
+{
+    ThreadPool pool(2);
+    const file_path path = std::filesystem::temp_directory_path() / "cp_test_coroutine.bin";
+    const std::vector<uint8_t> bytes = {1, 2, 3, 5, 8, 13, 21};
+    filesystem::WriteBytes(path, bytes);
+
+    std::thread::id reader;
+    Task<filesystem::FileBytes> read = ReadOnWorker(pool, path, reader);
+    read.Start();
+    CP_CHECK(testing::Eventually([&]
+                                 { return read.IsDone(); }));
+    const filesystem::FileBytes file = read.Get();
+    CP_CHECK(std::vector<uint8_t>(file.view().begin(), file.view().end()) == bytes);
+    CP_CHECK(reader != std::this_thread::get_id());
+    CP_CHECK(filesystem::DeleteFileSafe(path));
+
+    CP_CHECK_THROWS(SyncWait(pool, filesystem::ReadBytesAsync(pool, path)), std::runtime_error);
+}
+
+int main()
+{
+    return cp::testing::RunAll();
+}
@@ -0,0 +1,264 @@
+#include "testing.hpp"
+#include <cp_framework/events/eventQueue.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using cp::EventQueue;
+
+namespace
+{
+    /**
+     * @brief What the consumer saw, in dispatch order.
+     */
+    struct Log
+    {
+        std::vector<int> values;
+        std::vector<int> producers;
+    };
+
+    std::atomic<int> g_live{0};         ///< Live events of every test type.
+
+    template <size_t Padding>
+    struct Sized
+    {
+        int value;
+        int producer = 0;
+        std::array<char, Padding> padding{};
+
+        explicit Sized(int v, int p = 0) : value(v), producer(p) { g_live.fetch_add(1); }
+        Sized(const Sized &other) : value(other.value), producer(other.producer) { g_live.fetch_add(1); }
+        ~Sized() { g_live.fetch_sub(1); }
+    };
+
+    struct alignas(64) OverAligned
+    {
+        int value;
+        explicit OverAligned(int v) : value(v) { g_live.fetch_add(1); }
+        ~OverAligned() { g_live.fetch_sub(1); }
+    };
+
+    template <typename T>
+    void Handle(void *context, void *payload)
+    {
+        T &event = *static_cast<T *>(payload);
+        if (context)
+        {
+            Log &log = *static_cast<Log *>(context);
+            log.values.push_back(event.value);
+            if constexpr (requires { event.producer; })
+                log.producers.push_back(event.producer);
+        }
+        event.~T();
+    }
+
+    /**
+     * @brief Same as Handle<T>, but a distinct function, as another DLL's copy of it would be.
+     */
+    template <typename T>
+    void HandleElsewhere(void *context, void *payload)
+    {
+        Handle<T>(context, payload);
+    }
+
+    uint32_t g_nextType = 0; ///< Next test type ID
+
+    template <typename T>
+    uint32_t TypeId()
+    {
+        static const uint32_t id = g_nextType++;
+        return id;
+    }
+
+    template <typename T, typename... Args>
+    void Push(EventQueue &queue, Args &&...args)
+    {
+        queue.Emplace<T>(TypeId<T>(), &Handle<T>, std::forward<Args>(args)...);
+    }
+}
+
+CP_TEST(GroupsByTypeKeepingQueueOrder)
+{
+    EventQueue queue(4096);
+    Push<Sized<0>>(queue, 1);
+    Push<Sized<8>>(queue, 100);
+    Push<Sized<0>>(queue, 2);
+    Push<Sized<8>>(queue, 101);
+    Push<Sized<0>>(queue, 3);
+
+    Log log;
+    CP_CHECK(queue.Consume(&log) == 5);
+    CP_CHECK((log.values == std::vector<int>{1, 2, 3, 100, 101}));
+    CP_CHECK(!queue.HasPending());
+    CP_CHECK(g_live.load() == 0);
+}
+
+// Grouping keys on the type ID: handler copies from different modules still share a group.
+CP_TEST(GroupsByTypeIdNotHandler)
+{
+    EventQueue queue(4096);
+    Push<Sized<0>>(queue, 1);
+    Push<Sized<8>>(queue, 100);
+    queue.Emplace<Sized<0>>(TypeId<Sized<0>>(), &HandleElsewhere<Sized<0>>, 2);
+    // Overflowed events carry their type ID too; the large payload under the same ID forces that path.
+    queue.Emplace<Sized<1024>>(TypeId<Sized<0>>(), &HandleElsewhere<Sized<1024>>, 3);
+
+    Log log;
+    CP_CHECK(queue.Consume(&log) == 4);
+    CP_CHECK((log.values == std::vector<int>{1, 2, 3, 100}));
+    CP_CHECK(g_live.load() == 0);
+}
+
+// Many rounds through a small ring: records wrap around its end and padding records are skipped.
+CP_TEST(WrapAroundTheRing)
+{
+    EventQueue queue(256);
+    Log log;
+    int next = 0;
+    for (int round = 0; round < 200; ++round)
+    {
+        for (int i = 0; i < 3; ++i)
+            Push<Sized<24>>(queue, next++);
+        queue.Consume(&log);
+    }
+
+    CP_CHECK(log.values.size() == 600);
+    for (int i = 0; i < static_cast<int>(log.values.size()); ++i)
+        CP_CHECK(log.values[i] == i);
+    CP_CHECK(g_live.load() == 0);
+}
+
+CP_TEST(OverflowKeepsOrder)
+{
+    EventQueue queue(256);
+    // Fills the ring, then spills: large and over-aligned events never fit inline.
+    for (int i = 0; i < 20; ++i)
+        Push<Sized<24>>(queue, i);
+    Push<Sized<1024>>(queue, 20);
+    Push<Sized<24>>(queue, 21);
+
+    Log log;
+    queue.Consume(&log);
+    std::vector<int> small;
+    for (int value : log.values)
+        if (value != 20)
+            small.push_back(value);
+    CP_CHECK(small.size() == 21);
+    for (int i = 0; i < 21; ++i)
+        CP_CHECK(small[i] == (i < 20 ? i : 21));
+
+    Push<OverAligned>(queue, 7);
+    Push<Sized<0>>(queue, 8);
+    log.values.clear();
+    queue.Consume(&log);
+    CP_CHECK((log.values == std::vector<int>{7, 8}));
+    CP_CHECK(g_live.load() == 0);
+}
+
+CP_TEST(BudgetCarriesTheRestOver)
+{
+    EventQueue queue(4096);
+    for (int i = 0; i < 10; ++i)
+        Push<Sized<0>>(queue, i);
+
+    Log log;
+    // A zero budget still dispatches one event per call.
+    CP_CHECK(queue.Consume(&log, std::chrono::nanoseconds(0)) == 1);
+    Push<Sized<0>>(queue, 10);
+    CP_CHECK(queue.HasPending());
+    while (queue.Consume(&log, std::chrono::nanoseconds(0)))
+    {
+    }
+    CP_CHECK(log.values.size() == 11);
+    for (int i = 0; i < 11; ++i)
+        CP_CHECK(log.values[i] == i);
+}
+
+CP_TEST(ThrowingHandlerFreesItsEvent)
+{
+    EventQueue queue(4096);
+    struct Boom
+    {
+        static void Handle(void *context, void *payload)
+        {
+            static_cast<Sized<0> *>(payload)->~Sized();
+            if (context)
+                throw std::runtime_error("listener");
+        }
+    };
+    queue.Emplace<Sized<0>>(TypeId<Sized<0>>(), &Boom::Handle, 1);
+    Push<Sized<0>>(queue, 2);
+
+    Log log;
+    CP_CHECK_THROWS(queue.Consume(&log), std::runtime_error);
+    CP_CHECK(queue.Consume(&log) == 1);
+    CP_CHECK((log.values == std::vector<int>{2}));
+    CP_CHECK(g_live.load() == 0);
+}
+
+// Producers race each other and the consumer; each producer's events arrive in its order.
+CP_TEST(ConcurrentProducersStress)
+{
+    constexpr int kProducers = 4;
+    constexpr int kEvents = 20000;
+
+    EventQueue queue(4096);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p)
+        producers.emplace_back([&queue, p]
+                               {
+                                   for (int i = 0; i < kEvents; ++i)
+                                   {
+                                       if (i % 97 == 0)
+                                           Push<Sized<512>>(queue, i, p);
+                                       else
+                                           Push<Sized<0>>(queue, i, p);
+                                   } });
+
+    Log log;
+    std::array<int, kProducers> lastSmall{}, lastLarge{};
+    lastSmall.fill(-1);
+    lastLarge.fill(-1);
+    bool ordered = true;
+    size_t consumed = 0;
+    while (consumed < size_t(kProducers) * kEvents)
+    {
+        log.values.clear();
+        log.producers.clear();
+        consumed += queue.Consume(&log);
+        // Grouping reorders across types; within one type a producer's events stay in order.
+        for (size_t i = 0; i < log.values.size(); ++i)
+        {
+            int &previous = log.values[i] % 97 == 0 ? lastLarge[log.producers[i]] : lastSmall[log.producers[i]];
+            ordered &= log.values[i] > previous;
+            previous = log.values[i];
+        }
+    }
+    for (std::thread &producer : producers)
+        producer.join();
+    consumed += queue.Consume(&log);
+
+    CP_CHECK(ordered);
+    CP_CHECK(consumed == size_t(kProducers) * kEvents);
+    CP_CHECK(!queue.HasPending());
+    CP_CHECK(g_live.load() == 0);
+}
+
+CP_TEST(DestructorDestroysPendingEvents)
+{
+    {
+        EventQueue queue(256);
+        for (int i = 0; i < 20; ++i)
+            Push<Sized<24>>(queue, i);
+        Push<Sized<1024>>(queue, 20);
+    }
+    CP_CHECK(g_live.load() == 0);
+}
+
+int main()
+{
+    return cp::testing::RunAll();
+}
@@ -0,0 +1,227 @@
+#include "testing.hpp"
+#include <cp_framework/events/events.hpp>
+#include <cp_framework/threading/threadPool.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cp;
+
+namespace
+{
+    struct Ping : Event
+    {
+        int value = 0;
+        explicit Ping(int v = 0) : value(v) {}
+    };
+
+    struct Pong : Event
+    {
+        std::string text;
+        explicit Pong(std::string t) : text(std::move(t)) {}
+    };
+}
+
+CP_TEST(EmitRespectsPriorities)
+{
+    EventDispatcher dispatcher;
+    std::vector<int> order;
+    dispatcher.Subscribe<Ping>([&](const Ping &)
+                               { order.push_back(0); });
+    dispatcher.Subscribe<Ping>([&](const Ping &)
+                               { order.push_back(10); },
+                               10);
+    const ListenerID removed = dispatcher.Subscribe<Ping>([&](const Ping &)
+                                                          { order.push_back(-1); },
+                                                          5);
+    dispatcher.Subscribe<Ping>([&](const Ping &)
+                               { order.push_back(1); });
+    dispatcher.Unsubscribe<Ping>(removed);
+
+    dispatcher.Emit(Ping(1));
+    CP_CHECK((order == std::vector<int>{10, 0, 1}));
+}
+
+CP_TEST(TypeIdsAreDense)
+{
+    const EventTypeID ping = EventTypeId<Ping>();
+    const EventTypeID pong = EventTypeId<Pong>();
+    CP_CHECK(ping != pong);
+    CP_CHECK(EventTypeId<Ping>() == ping);
+    CP_CHECK(RegisterEventType(typeid(Pong)) == pong);
+}
+
+// Listeners come and go while other threads emit; an emit sees either the old or the new list.
+CP_TEST(SubscribeAndUnsubscribeDuringEmit)
+{
+    EventDispatcher dispatcher;
+    std::atomic<int> stable{0};
+    dispatcher.Subscribe<Ping>([&](const Ping &)
+                               { stable.fetch_add(1, std::memory_order_relaxed); });
+
+    constexpr int kEmitters = 3;
+    constexpr int kEmits = 20000;
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> emitters;
+    for (int e = 0; e < kEmitters; ++e)
+        emitters.emplace_back([&]
+                              {
+                                  for (int i = 0; i < kEmits; ++i)
+                                      dispatcher.Emit(Ping(i)); });
+
+    std::thread churn([&]
+                      {
+                          std::atomic<int> transient{0};
+                          while (!stop.load())
+                          {
+                              const ListenerID id = dispatcher.Subscribe<Ping>([&transient](const Ping &)
+                                                                               { transient.fetch_add(1); });
+                              dispatcher.Unsubscribe<Ping>(id);
+                          } });
+
+    for (std::thread &emitter : emitters)
+        emitter.join();
+    stop = true;
+    churn.join();
+
+    CP_CHECK(stable.load() == kEmitters * kEmits);
+}
+
+// Two threads relay emits so one is always in flight while listeners churn; replaced lists must still be freed.
+CP_TEST(RetiredListenersAreFreedWhileEmitsOverlap)
+{
+    constexpr int kEmits = 2000;
+    EventDispatcher dispatcher;
+    // Every live listener list holds a copy of the callback below, and with it a reference to token.
+    auto token = std::make_shared<int>(0);
+    std::atomic<long> mostCopies{0};
+    std::atomic<int> started{-1};
+    dispatcher.Subscribe<Ping>([&, token](const Ping &e)
+                               {
+                                   const ListenerID churn = dispatcher.Subscribe<Ping>([](const Ping &) {});
+                                   dispatcher.Unsubscribe<Ping>(churn);
+
+                                   long copies = mostCopies.load();
+                                   while (copies < token.use_count() && !mostCopies.compare_exchange_weak(copies, token.use_count()))
+                                   {
+                                   }
+
+                                   // Return only once the next emit has begun.
+                                   started.store(e.value);
+                                   while (e.value + 1 < kEmits && started.load() <= e.value)
+                                       std::this_thread::yield(); });
+
+    std::vector<std::thread> emitters;
+    for (int first = 0; first < 2; ++first)
+        emitters.emplace_back([&, first]
+                              {
+                                  for (int value = first; value < kEmits; value += 2)
+                                  {
+                                      while (started.load() < value - 1)
+                                          std::this_thread::yield();
+                                      dispatcher.Emit(Ping(value));
+                                  } });
+    for (std::thread &emitter : emitters)
+        emitter.join();
+
+    // Without reclamation every list replaced during the run would still be alive.
+    CP_CHECK(mostCopies.load() < 16);
+    // Ours and the current list.
+    CP_CHECK(token.use_count() == 2);
+}
+
+CP_TEST(ListenersMayChangeSubscriptionsFromTheirCallback)
+{
+    EventDispatcher dispatcher;
+    int calls = 0;
+    ListenerID self = 0;
+    self = dispatcher.Subscribe<Ping>([&](const Ping &)
+                                      {
+                                          ++calls;
+                                          dispatcher.Unsubscribe<Ping>(self);
+                                          dispatcher.Subscribe<Pong>([](const Pong &) {}); });
+    dispatcher.Emit(Ping());
+    dispatcher.Emit(Ping());
+    CP_CHECK(calls == 1);
+}
+
+CP_TEST(QueuedEventsAreGroupedByType)
+{
+    EventDispatcher dispatcher(4096);
+    std::vector<std::string> seen;
+    dispatcher.Subscribe<Ping>([&](const Ping &e)
+                               { seen.push_back(std::to_string(e.value)); });
+    dispatcher.Subscribe<Pong>([&](const Pong &e)
+                               { seen.push_back(e.text); });
+
+    dispatcher.QueueEvent(Ping(1));
+    dispatcher.QueueEvent<Pong>("a");
+    dispatcher.QueueEvent<Ping>(2);
+    dispatcher.QueueEvent(Pong("b"));
+
+    CP_CHECK(dispatcher.DispatchQueued() == 4);
+    CP_CHECK((seen == std::vector<std::string>{"1", "2", "a", "b"}));
+    CP_CHECK(dispatcher.DispatchQueued() == 0);
+}
+
+CP_TEST(AsyncThreadDispatches)
+{
+    EventDispatcher dispatcher;
+    std::atomic<int> sum{0};
+    dispatcher.Subscribe<Ping>([&](const Ping &e)
+                               { sum.fetch_add(e.value); });
+    dispatcher.StartAsync();
+    for (int i = 1; i <= 1000; ++i)
+        dispatcher.QueueEvent<Ping>(i);
+    CP_CHECK(testing::Eventually([&]
+                                 { return sum.load() == 1000 * 1001 / 2; }));
+    dispatcher.StopAsync();
+}
+
+CP_TEST(ParallelListenersFanOutPerTier)
+{
+    ThreadPool pool(4);
+    EventDispatcher dispatcher;
+    dispatcher.SetThreadPool(&pool);
+
+    std::mutex mutex;
+    std::vector<int> tiers;
+    std::atomic<int> parallelRuns{0};
+    const std::thread::id caller = std::this_thread::get_id();
+    bool serialOnCaller = true;
+
+    for (int i = 0; i < 16; ++i)
+        dispatcher.Subscribe<Ping>([&](const Ping &)
+                                   {
+                                       parallelRuns.fetch_add(1);
+                                       std::lock_guard<std::mutex> lock(mutex);
+                                       tiers.push_back(10); },
+                                   10, ListenerExecution::Parallel);
+    dispatcher.Subscribe<Ping>([&](const Ping &)
+                               {
+                                   serialOnCaller &= std::this_thread::get_id() == caller;
+                                   std::lock_guard<std::mutex> lock(mutex);
+                                   tiers.push_back(0); });
+
+    for (int i = 0; i < 10; ++i)
+        dispatcher.QueueEvent<Ping>(i);
+    dispatcher.DispatchQueued();
+    dispatcher.SetThreadPool(nullptr);
+
+    CP_CHECK(parallelRuns.load() == 160);
+    CP_CHECK(serialOnCaller);
+    // Per event, all 16 parallel listeners of the higher tier ran before the serial one.
+    bool ordered = tiers.size() == 170;
+    for (size_t i = 0; ordered && i < tiers.size(); ++i)
+        ordered = tiers[i] == (i % 17 == 16 ? 0 : 10);
+    CP_CHECK(ordered);
+}
+
+int main()
+{
+    return cp::testing::RunAll();
+}
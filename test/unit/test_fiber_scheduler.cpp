@@ -0,0 +1,109 @@
+#include "testing.hpp"
+#include <cp_framework/threading/fiberScheduler.hpp>
+#include <atomic>
+
+using namespace cp;
+
+CP_TEST(CounterWaitOutsideAFiber)
+{
+    ThreadPool pool(4);
+    FiberScheduler fibers(pool);
+    JobCounter counter;
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 100; ++i)
+        fibers.Run([&ran]
+                   { ran.fetch_add(1); },
+                   &counter);
+    fibers.WaitForCounter(counter);
+    CP_CHECK(counter.Value() == 0);
+    CP_CHECK(ran.load() == 100);
+}
+
+// Parents suspend on their children's counter; fibers outnumber workers many times over.
+CP_TEST(NestedWaitsSuspendFibers)
+{
+    ThreadPool pool(2);
+    FiberConfig config;
+    config.fiberCount = 8;
+    FiberScheduler fibers(pool, config);
+
+    constexpr int kParents = 32;
+    constexpr int kChildren = 8;
+    std::atomic<int> leaves{0};
+    std::atomic<int> finished{0};
+    JobCounter all;
+    for (int p = 0; p < kParents; ++p)
+        fibers.Run([&]
+                   {
+                       JobCounter children;
+                       for (int c = 0; c < kChildren; ++c)
+                           fibers.Run([&leaves]
+                                      { leaves.fetch_add(1); },
+                                      &children);
+                       fibers.WaitForCounter(children);
+                       // Every child is done once the parent resumes.
+                       if (children.Value() == 0)
+                           finished.fetch_add(1); },
+                   &all);
+    fibers.WaitForCounter(all);
+
+    CP_CHECK(finished.load() == kParents);
+    CP_CHECK(leaves.load() == kParents * kChildren);
+    CP_CHECK(fibers.GetFiberCount() >= config.fiberCount);
+    CP_CHECK(fibers.GetSwitchCount() > 0);
+}
+
+CP_TEST(PartialTargets)
+{
+    ThreadPool pool(2);
+    FiberScheduler fibers(pool);
+    JobCounter counter;
+    std::atomic<int> ran{0};
+    JobCounter outer;
+    fibers.Run([&]
+               {
+                   for (int i = 0; i < 10; ++i)
+                       fibers.Run([&ran]
+                                  { ran.fetch_add(1); },
+                                  &counter);
+                   // Resumes once at most 5 jobs are left.
+                   fibers.WaitForCounter(counter, 5);
+                   CP_CHECK(ran.load() >= 5); },
+               &outer);
+    fibers.WaitForCounter(outer);
+    fibers.WaitForCounter(counter);
+    CP_CHECK(ran.load() == 10);
+}
+
+// Shutdown() drains suspended fibers too: their resumes come from workers, which stay accepted.
+CP_TEST(ShutdownFinishesSuspendedFibers)
+{
+    ThreadPool pool(2);
+    FiberScheduler fibers(pool);
+    std::atomic<int> leaves{0};
+    JobCounter all;
+    for (int p = 0; p < 16; ++p)
+        fibers.Run([&]
+                   {
+                       JobCounter children;
+                       for (int c = 0; c < 8; ++c)
+                           fibers.Run([&leaves]
+                                      { leaves.fetch_add(1); },
+                                      &children);
+                       fibers.WaitForCounter(children); },
+                   &all);
+    pool.Shutdown();
+
+    CP_CHECK(all.Value() == 0);
+    CP_CHECK(leaves.load() == 16 * 8);
+
+    // A rejected job leaves its counter settled, so neither a wait nor the destructor hangs.
+    CP_CHECK_THROWS(fibers.Run([] {}, &all), std::runtime_error);
+    CP_CHECK(all.Value() == 0);
+    fibers.WaitForCounter(all);
+}
+
+int main()
+{
+    return cp::testing::RunAll();
+}
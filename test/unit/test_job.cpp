@@ -0,0 +1,101 @@
+#include "testing.hpp"
+#include <cp_framework/threading/job.hpp>
+#include <array>
+#include <memory>
+#include <utility>
+
+using cp::Job;
+
+namespace
+{
+    /**
+     * @brief Callable counting its live instances, padded to @p Size bytes.
+     */
+    template <size_t Size>
+    struct Counted
+    {
+        static inline int live = 0;
+
+        int *calls;
+        std::array<char, Size> padding{};
+
+        explicit Counted(int *c) : calls(c) { ++live; }
+        Counted(const Counted &other) : calls(other.calls) { ++live; }
+        Counted(Counted &&other) noexcept : calls(other.calls) { ++live; }
+        ~Counted() { --live; }
+
+        void operator()() { ++*calls; }
+    };
+
+    using Small = Counted<16>;
+    using Large = Counted<Job::kInlineSize>;
+}
+
+CP_TEST(SmallCallablesAreStoredInline)
+{
+    static_assert(Job::FitsInline<Small>());
+    static_assert(!Job::FitsInline<Large>());
+
+    auto lambda = [value = 1] { (void)value; };
+    static_assert(Job::FitsInline<decltype(lambda)>());
+}
+
+CP_TEST(InvokeMoveAndDestroy)
+{
+    int calls = 0;
+    {
+        Job job{Small(&calls)};
+        CP_CHECK(static_cast<bool>(job));
+        CP_CHECK(Small::live == 1);
+
+        job();
+        Job moved(std::move(job));
+        CP_CHECK(!job);
+        CP_CHECK(Small::live == 1);
+
+        moved();
+        Job assigned;
+        assigned = std::move(moved);
+        assigned();
+        CP_CHECK(calls == 3);
+        CP_CHECK(Small::live == 1);
+
+        assigned.Reset();
+        CP_CHECK(!assigned);
+        CP_CHECK(Small::live == 0);
+    }
+    CP_CHECK(Small::live == 0);
+}
+
+CP_TEST(LargeCallablesFallBackToTheHeap)
+{
+    int calls = 0;
+    {
+        Job job{Large(&calls)};
+        Job moved(std::move(job));
+        moved();
+        CP_CHECK(calls == 1);
+        CP_CHECK(Large::live == 1);
+
+        // Assigning over a live job destroys the previous callable.
+        moved = Job(Large(&calls));
+        CP_CHECK(Large::live == 1);
+    }
+    CP_CHECK(Large::live == 0);
+}
+
+CP_TEST(MoveOnlyCallables)
+{
+    auto owned = std::make_unique<int>(41);
+    int result = 0;
+    Job job([value = std::move(owned), &result]
+            { result = *value + 1; });
+    Job moved(std::move(job));
+    moved();
+    CP_CHECK(result == 42);
+}
+
+int main()
+{
+    return cp::testing::RunAll();
+}
@@ -0,0 +1,161 @@
+#include "testing.hpp"
+#include <cp_framework/threading/coroutine.hpp>
+#include <cp_framework/threading/mainThreadQueue.hpp>
+#include <cp_framework/threading/threadPool.hpp>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace cp;
+using namespace std::chrono_literals;
+
+namespace
+{
+    Task<bool> HopToMainThread(ThreadPool &pool, MainThreadQueue &main, std::thread::id &worker)
+    {
+        co_await pool.Schedule();
+        worker = std::this_thread::get_id();
+        co_await main.Schedule();
+        co_return main.IsMainThread();
+    }
+}
+
+// Producers race each other, but each one's tasks run in the order it posted them.
+CP_TEST(TasksFromEachProducerRunInOrder)
+{
+    constexpr int kProducers = 4;
+    constexpr int kTasksPerProducer = 20000;
+
+    MainThreadQueue queue;
+    std::vector<std::pair<int, int>> ran;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p)
+        producers.emplace_back([&, p]
+                               {
+                                   for (int i = 0; i < kTasksPerProducer; ++i)
+                                       queue.Post([&ran, p, i]
+                                                  { ran.emplace_back(p, i); }); });
+
+    // Drain concurrently with the producers, then pick up the rest.
+    while (ran.size() < kProducers * kTasksPerProducer / 2)
+        queue.Drain();
+    for (std::thread &producer : producers)
+        producer.join();
+    queue.Drain();
+
+    CP_CHECK(ran.size() == kProducers * kTasksPerProducer);
+    CP_CHECK(queue.Pending() == 0);
+    std::vector<int> next(kProducers, 0);
+    bool ordered = true;
+    for (const auto &[producer, index] : ran)
+        ordered &= index == next[producer]++;
+    CP_CHECK(ordered);
+}
+
+CP_TEST(DrainRunsAtLeastOneTaskAndStopsAtTheBudget)
+{
+    MainThreadQueue queue;
+    int ran = 0;
+    for (int i = 0; i < 4; ++i)
+        queue.Post([&ran]
+                   {
+                       ++ran;
+                       std::this_thread::sleep_for(2ms); });
+
+    // A zero budget still makes progress.
+    CP_CHECK(queue.Drain(0ns) == 1);
+    CP_CHECK(ran == 1);
+    // The budget is checked after each task, so one 2ms task exhausts a 1ms budget.
+    CP_CHECK(queue.Drain(1ms) == 1);
+    CP_CHECK(ran == 2);
+    CP_CHECK(queue.Pending() == 2);
+    CP_CHECK(queue.Drain() == 2);
+    CP_CHECK(queue.Drain(0ns) == 0);
+}
+
+CP_TEST(TasksPostedDuringDrainRunInTheNextDrain)
+{
+    MainThreadQueue queue;
+    int ran = 0;
+    std::function<void()> repost = [&]
+    {
+        ++ran;
+        queue.Post(repost);
+    };
+    queue.Post(repost);
+    queue.Post([&ran]
+               { ++ran; });
+
+    CP_CHECK(queue.Drain() == 2);
+    CP_CHECK(ran == 2);
+    CP_CHECK(queue.Pending() == 1);
+    CP_CHECK(queue.Drain() == 1);
+    CP_CHECK(ran == 3);
+}
+
+CP_TEST(SubmitReportsResultsAndErrors)
+{
+    MainThreadQueue queue;
+    std::future<int> answer;
+    std::future<void> failing;
+    std::thread producer([&]
+                         {
+                             answer = queue.Submit([&queue]
+                                                   { return queue.IsMainThread() ? 42 : 0; });
+                             failing = queue.Submit([]
+                                                    { throw std::runtime_error("boom"); }); });
+    producer.join();
+
+    CP_CHECK(queue.Drain() == 2);
+    CP_CHECK(answer.get() == 42);
+    CP_CHECK_THROWS(failing.get(), std::runtime_error);
+}
+
+CP_TEST(DestroyingTheQueueBreaksPendingPromises)
+{
+    auto queue = std::make_unique<MainThreadQueue>();
+    bool ran = false;
+    std::future<void> dropped = queue->Submit([&ran]
+                                              { ran = true; });
+    queue.reset();
+
+    CP_CHECK(!ran);
+    bool broken = false;
+    try
+    {
+        dropped.get();
+    }
+    catch (const std::future_error &e)
+    {
+        broken = e.code() == std::future_errc::broken_promise;
+    }
+    CP_CHECK(broken);
+}
+
+CP_TEST(ScheduleResumesCoroutinesOnTheMainThread)
+{
+    ThreadPool pool(2);
+    MainThreadQueue queue;
+    std::thread::id worker;
+    Task<bool> task = HopToMainThread(pool, queue, worker);
+    task.Start();
+
+    CP_CHECK(testing::Eventually([&]
+                                 {
+                                     queue.Drain();
+                                     return task.IsDone(); }));
+    CP_CHECK(task.Get());
+    CP_CHECK(worker != std::this_thread::get_id());
+
+    // Already on the main thread: no round trip through the queue.
+    CP_CHECK(queue.Schedule().await_ready());
+}
+
+int main()
+{
+    return cp::testing::RunAll();
+}
@@ -0,0 +1,214 @@
+#include "testing.hpp"
+#include <cp_framework/threading/parallelAlgorithms.hpp>
+#include <cp_framework/threading/threadPool.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace cp;
+
+namespace
+{
+    // Empty, single-element, either side of the sequential fallback, and several blocks per worker.
+    const size_t kSizes[] = {0, 1, parallel::kSequentialThreshold - 1, parallel::kSequentialThreshold,
+                             parallel::kSequentialThreshold + 1, 100003};
+
+    /**
+     * @brief A sort key with few distinct values and the element's original position.
+     */
+    struct Record
+    {
+        int32_t key;  ///< Sort key; repeats often so stability is observable.
+        size_t index; ///< Position before sorting.
+
+        bool operator==(const Record &) const = default;
+    };
+
+    /**
+     * @brief x -> a * x + b; composition is associative but not commutative.
+     */
+    struct Affine
+    {
+        uint32_t a = 1;
+        uint32_t b = 0;
+
+        bool operator==(const Affine &) const = default;
+    };
+
+    /// Applies @p first, then @p second.
+    Affine Compose(const Affine &first, const Affine &second)
+    {
+        return {first.a * second.a, first.b * second.a + second.b};
+    }
+
+    template <typename T>
+    std::vector<T> RandomInts(size_t n, T low, T high)
+    {
+        std::mt19937_64 rng(n);
+        std::uniform_int_distribution<T> dist(low, high);
+        std::vector<T> values(n);
+        for (T &value : values)
+            value = dist(rng);
+        return values;
+    }
+
+    std::vector<Record> RandomRecords(size_t n)
+    {
+        const std::vector<int32_t> keys = RandomInts<int32_t>(n, -50, 50);
+        std::vector<Record> records(n);
+        for (size_t i = 0; i < n; ++i)
+            records[i] = {keys[i], i};
+        return records;
+    }
+
+    bool ByKey(const Record &a, const Record &b) { return a.key < b.key; }
+}
+
+CP_TEST(SortMatchesStdSort)
+{
+    ThreadPool pool(4);
+    for (size_t n : kSizes)
+    {
+        // Integers take the radix path, a custom ordering the merge path.
+        std::vector<int64_t> values = RandomInts<int64_t>(n, INT64_MIN, INT64_MAX);
+        std::vector<int64_t> expected = values;
+        parallel::Sort(pool, values.begin(), values.end());
+        std::sort(expected.begin(), expected.end());
+        CP_CHECK(values == expected);
+
+        std::vector<int32_t> descending = RandomInts<int32_t>(n, -1000, 1000);
+        expected.assign(descending.begin(), descending.end());
+        parallel::Sort(pool, descending.begin(), descending.end(), std::greater<>());
+        std::sort(expected.begin(), expected.end(), std::greater<>());
+        CP_CHECK(std::equal(descending.begin(), descending.end(), expected.begin(), expected.end()));
+    }
+}
+
+CP_TEST(StableSortKeepsEqualElementsInOrder)
+{
+    ThreadPool pool(4);
+    for (size_t n : kSizes)
+    {
+        std::vector<Record> records = RandomRecords(n);
+        std::vector<Record> expected = records;
+        parallel::StableSort(pool, records.begin(), records.end(), ByKey);
+        std::stable_sort(expected.begin(), expected.end(), ByKey);
+        CP_CHECK(records == expected);
+
+        std::vector<uint16_t> values = RandomInts<uint16_t>(n, 0, UINT16_MAX);
+        std::vector<uint16_t> sorted = values;
+        parallel::StableSort(pool, values.begin(), values.end());
+        std::stable_sort(sorted.begin(), sorted.end());
+        CP_CHECK(values == sorted);
+    }
+}
+
+CP_TEST(SortByKeyMatchesStdStableSort)
+{
+    ThreadPool pool(4);
+    for (size_t n : kSizes)
+    {
+        // Signed keys must order negatives first.
+        std::vector<Record> records = RandomRecords(n);
+        std::vector<Record> expected = records;
+        parallel::SortByKey(pool, records.begin(), records.end(), [](const Record &r)
+                            { return r.key; });
+        std::stable_sort(expected.begin(), expected.end(), ByKey);
+        CP_CHECK(records == expected);
+    }
+}
+
+CP_TEST(InclusiveScanMatchesStd)
+{
+    ThreadPool pool(4);
+    for (size_t n : kSizes)
+    {
+        const std::vector<int64_t> values = RandomInts<int64_t>(n, -1000, 1000);
+        std::vector<int64_t> expected(n);
+        std::inclusive_scan(values.begin(), values.end(), expected.begin());
+
+        std::vector<int64_t> out(n);
+        CP_CHECK(parallel::InclusiveScan(pool, values.begin(), values.end(), out.begin()) == out.end());
+        CP_CHECK(out == expected);
+
+        std::vector<int64_t> inPlace = values;
+        parallel::InclusiveScan(pool, inPlace.begin(), inPlace.end(), inPlace.begin());
+        CP_CHECK(inPlace == expected);
+
+        // Block carries must be combined on the correct side.
+        const std::vector<uint32_t> factors = RandomInts<uint32_t>(n, 0, UINT32_MAX);
+        std::vector<Affine> steps(n);
+        for (size_t i = 0; i < n; ++i)
+            steps[i] = {factors[i] | 1u, factors[i] >> 7};
+        std::vector<Affine> composed(n), expectedComposed(n);
+        parallel::InclusiveScan(pool, steps.begin(), steps.end(), composed.begin(), Compose);
+        std::inclusive_scan(steps.begin(), steps.end(), expectedComposed.begin(), Compose);
+        CP_CHECK(composed == expectedComposed);
+    }
+}
+
+CP_TEST(ExclusiveScanMatchesStd)
+{
+    ThreadPool pool(4);
+    for (size_t n : kSizes)
+    {
+        const std::vector<int64_t> values = RandomInts<int64_t>(n, -1000, 1000);
+        std::vector<int64_t> expected(n);
+        std::exclusive_scan(values.begin(), values.end(), expected.begin(), int64_t(7));
+
+        std::vector<int64_t> out(n);
+        CP_CHECK(parallel::ExclusiveScan(pool, values.begin(), values.end(), out.begin(), int64_t(7)) == out.end());
+        CP_CHECK(out == expected);
+
+        std::vector<int64_t> inPlace = values;
+        parallel::ExclusiveScan(pool, inPlace.begin(), inPlace.end(), inPlace.begin(), int64_t(7));
+        CP_CHECK(inPlace == expected);
+
+        const std::vector<uint32_t> factors = RandomInts<uint32_t>(n, 0, UINT32_MAX);
+        std::vector<Affine> steps(n);
+        for (size_t i = 0; i < n; ++i)
+            steps[i] = {factors[i] | 1u, factors[i] >> 7};
+        std::vector<Affine> composed(n), expectedComposed(n);
+        parallel::ExclusiveScan(pool, steps.begin(), steps.end(), composed.begin(), Affine{3, 1}, Compose);
+        std::exclusive_scan(steps.begin(), steps.end(), expectedComposed.begin(), Affine{3, 1}, Compose);
+        CP_CHECK(composed == expectedComposed);
+    }
+}
+
+CP_TEST(PartitionMatchesStdStablePartition)
+{
+    ThreadPool pool(4);
+    for (size_t n : kSizes)
+    {
+        for (int divisor : {1, 3, 1000})
+        {
+            const auto pred = [divisor](const Record &r)
+            { return r.key % divisor == 0; };
+            std::vector<Record> records = RandomRecords(n);
+            std::vector<Record> expected = records;
+            const auto split = parallel::Partition(pool, records.begin(), records.end(), pred);
+            const auto expectedSplit = std::stable_partition(expected.begin(), expected.end(), pred);
+            CP_CHECK(records == expected);
+            CP_CHECK(split - records.begin() == expectedSplit - expected.begin());
+        }
+    }
+}
+
+// A single worker never forks; the sequential fallback must cover every size.
+CP_TEST(SingleThreadedPoolFallsBack)
+{
+    ThreadPool pool(1);
+    std::vector<Record> records = RandomRecords(100003);
+    std::vector<Record> expected = records;
+    parallel::StableSort(pool, records.begin(), records.end(), ByKey);
+    std::stable_sort(expected.begin(), expected.end(), ByKey);
+    CP_CHECK(records == expected);
+}
+
+int main()
+{
+    return cp::testing::RunAll();
+}
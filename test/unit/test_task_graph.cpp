@@ -0,0 +1,203 @@
+#include "testing.hpp"
+#include <cp_framework/threading/jobFence.hpp>
+#include <cp_framework/threading/taskGraph.hpp>
+#include <cp_framework/threading/threadPool.hpp>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace cp;
+
+CP_TEST(DependenciesOrderNodes)
+{
+    ThreadPool pool(4);
+    TaskGraph graph;
+    std::mutex mutex;
+    std::vector<char> order;
+    auto record = [&](char name)
+    {
+        return [&, name]
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(name);
+        };
+    };
+
+    // a -> {b, c} -> d, then e after d.
+    auto a = graph.Emplace(record('a'));
+    auto b = a.Then(record('b'));
+    auto c = a.Then(record('c'));
+    auto d = graph.WhenAll({b, c}, record('d'));
+    d.Then(record('e'));
+
+    for (int run = 0; run < 50; ++run)
+    {
+        order.clear();
+        graph.Run(pool);
+        graph.Wait();
+        CP_CHECK(graph.IsComplete());
+        CP_CHECK(order.size() == 5);
+        CP_CHECK(order.front() == 'a');
+        CP_CHECK(order[3] == 'd' && order[4] == 'e');
+    }
+}
+
+CP_TEST(WhenAnyRunsOnceAndWaitsForNothingElse)
+{
+    ThreadPool pool(4);
+    TaskGraph graph;
+    std::atomic<int> races{0};
+    std::atomic<int> sources{0};
+    auto first = graph.Emplace([&]
+                               { sources.fetch_add(1); });
+    auto second = graph.Emplace([&]
+                                { sources.fetch_add(1); });
+    graph.WhenAny({first, second}, [&]
+                  { races.fetch_add(1); });
+
+    graph.Run(pool);
+    graph.Wait();
+    CP_CHECK(races.load() == 1);
+    CP_CHECK(sources.load() == 2);
+}
+
+CP_TEST(WideGraphStress)
+{
+    ThreadPool pool(4);
+    TaskGraph graph;
+    std::atomic<int> ran{0};
+    auto root = graph.Emplace([&]
+                              { ran.fetch_add(1); });
+    std::vector<TaskGraph::Node> layer;
+    for (int i = 0; i < 256; ++i)
+        layer.push_back(root.Then([&]
+                                  { ran.fetch_add(1); }));
+    auto join = graph.Emplace([&]
+                              { ran.fetch_add(1); });
+    for (TaskGraph::Node node : layer)
+        node.Precede(join);
+
+    for (int run = 1; run <= 20; ++run)
+    {
+        graph.Run(pool);
+        graph.Wait();
+        CP_CHECK(ran.load() == run * 258);
+    }
+}
+
+CP_TEST(ErrorsAndCycles)
+{
+    ThreadPool pool(2);
+    TaskGraph graph;
+    std::atomic<bool> after{false};
+    auto failing = graph.Emplace([]
+                                 { throw std::runtime_error("node"); });
+    failing.Then([&]
+                 { after = true; });
+
+    graph.Run(pool);
+    CP_CHECK_THROWS(graph.Wait(), std::runtime_error);
+    // Successors still run: an error does not cancel the rest of the graph.
+    CP_CHECK(after.load());
+
+    TaskGraph cyclic;
+    auto x = cyclic.Emplace([] {});
+    auto y = x.Then([] {});
+    y.Precede(x);
+    CP_CHECK_THROWS(cyclic.Run(pool), std::logic_error);
+}
+
+CP_TEST(JobFenceJoinsItsJobs)
+{
+    ThreadPool pool(4);
+    JobFence fence(pool);
+    std::atomic<int> ran{0};
+    for (int frame = 1; frame <= 100; ++frame)
+    {
+        for (int i = 0; i < 32; ++i)
+            fence.Dispatch([&ran]
+                           { ran.fetch_add(1); });
+        fence.Wait();
+        CP_CHECK(fence.IsComplete());
+        CP_CHECK(ran.load() == frame * 32);
+    }
+
+    fence.Dispatch([]
+                   { throw std::runtime_error("job"); });
+    CP_CHECK_THROWS(fence.Wait(), std::runtime_error);
+    // The error is consumed by the Wait() that reported it.
+    fence.Wait();
+}
+
+CP_TEST(ShutdownMidRunStillCompletes)
+{
+    ThreadPool pool(1);
+    TaskGraph graph;
+    std::atomic<bool> gate{false};
+    std::atomic<int> ran{0};
+    TaskGraph::Node root = graph.Emplace([&]
+                                         {
+                                             while (!gate.load())
+                                                 std::this_thread::yield();
+                                             ran.fetch_add(1); });
+    TaskGraph::Node last = root;
+    for (int i = 0; i < 100; ++i)
+        last = last.Then([&ran]
+                         { ran.fetch_add(1); });
+
+    graph.Run(pool);
+    std::thread stopper([&pool]
+                        { pool.Shutdown(); });
+    gate = true;
+    stopper.join();
+
+    // Successors are dispatched by the draining worker, which Shutdown() still accepts.
+    graph.Wait();
+    CP_CHECK(graph.IsComplete());
+    CP_CHECK(ran.load() == 101);
+
+    CP_CHECK_THROWS(graph.Run(pool), std::runtime_error);
+    CP_CHECK(graph.IsComplete());
+}
+
+// Jobs racing Shutdown() either run or are rejected; the fence never waits for a lost one.
+CP_TEST(JobFenceSurvivesShutdown)
+{
+    for (int round = 0; round < 50; ++round)
+    {
+        ThreadPool pool(2);
+        JobFence fence(pool);
+        std::atomic<int> ran{0};
+        int accepted = 0;
+        std::thread producer([&]
+                             {
+                                 try
+                                 {
+                                     for (;;)
+                                     {
+                                         fence.Dispatch([&ran]
+                                                        { ran.fetch_add(1); });
+                                         ++accepted;
+                                     }
+                                 }
+                                 catch (const std::runtime_error &)
+                                 {
+                                 } });
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        pool.Shutdown();
+        producer.join();
+
+        fence.Wait();
+        CP_CHECK(fence.IsComplete());
+        CP_CHECK(ran.load() == accepted);
+
+        CP_CHECK_THROWS(fence.Dispatch([] {}), std::runtime_error);
+        CP_CHECK(fence.IsComplete());
+    }
+}
+
+int main()
+{
+    return cp::testing::RunAll();
+}
@@ -0,0 +1,568 @@
+#include "testing.hpp"
+#include <cp_framework/threading/threadPool.hpp>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace cp;
+using namespace std::chrono_literals;
+
+CP_TEST(SubmitReturnsResults)
+{
+    ThreadPool pool(4);
+    auto sum = pool.Submit(TaskPriority::NORMAL, [](int a, int b)
+                           { return a + b; },
+                           20, 22);
+    auto text = pool.Submit(TaskPriority::HIGH, []
+                            { return std::string("done"); });
+    CP_CHECK(sum.get() == 42);
+    CP_CHECK(text.get() == "done");
+
+    auto failing = pool.Submit(TaskPriority::LOW, []() -> int
+                               { throw std::runtime_error("boom"); });
+    CP_CHECK_THROWS(failing.get(), std::runtime_error);
+}
+
+CP_TEST(DispatchFromManyProducers)
+{
+    constexpr int kProducers = 4;
+    constexpr int kJobsPerProducer = 20000;
+
+    ThreadPool pool(4);
+    std::atomic<int> ran{0};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p)
+        producers.emplace_back([&, p]
+                               {
+                                   const TaskPriority priority = static_cast<TaskPriority>(p % 3);
+                                   for (int i = 0; i < kJobsPerProducer; ++i)
+                                       pool.Dispatch(priority, [&ran]
+                                                     { ran.fetch_add(1, std::memory_order_relaxed); }); });
+    for (std::thread &producer : producers)
+        producer.join();
+
+    CP_CHECK(testing::Eventually([&]
+                                 { return ran.load() == kProducers * kJobsPerProducer; }));
+}
+
+// Tasks spawning tasks exercise worker-local pushes and stealing.
+CP_TEST(NestedSubmissionsAndHelpingWaits)
+{
+    ThreadPool pool(4);
+    std::atomic<int> leaves{0};
+    auto root = pool.Submit(TaskPriority::NORMAL, [&]
+                            {
+                                std::vector<std::future<void>> children;
+                                for (int i = 0; i < 64; ++i)
+                                    children.push_back(pool.Submit(TaskPriority::NORMAL, [&]
+                                                                   {
+                                                                       for (int j = 0; j < 16; ++j)
+                                                                           pool.Dispatch(TaskPriority::LOW, [&]
+                                                                                         { leaves.fetch_add(1); }); }));
+                                // Waiting inside a task must help rather than block the worker.
+                                pool.WaitAll(children); });
+    pool.Wait(root);
+    root.get();
+    CP_CHECK(testing::Eventually([&]
+                                 { return leaves.load() == 64 * 16; }));
+}
+
+CP_TEST(ParallelAlgorithms)
+{
+    ThreadPool pool(4);
+    std::vector<int> values(100000);
+    pool.ParallelFor(0, values.size(), 0, [&](size_t i)
+                     { values[i] = static_cast<int>(i % 7); });
+    CP_CHECK(std::accumulate(values.begin(), values.end(), 0LL) ==
+             pool.ParallelReduce(0, values.size(), 1000, 0LL, [&](size_t i)
+                                 { return static_cast<long long>(values[i]); }, std::plus<>()));
+
+    std::vector<int> doubled(values.size());
+    pool.ParallelTransform(values.begin(), values.end(), doubled.begin(), 0, [](int v)
+                           { return v * 2; });
+    CP_CHECK(doubled[12345] == values[12345] * 2);
+
+    CP_CHECK_THROWS(pool.ParallelFor(0, 1000, 10, [](size_t i)
+                                     { if (i == 500) throw std::runtime_error("piece"); }),
+                    std::runtime_error);
+}
+
+namespace
+{
+    /**
+     * @brief Occupies a pool's only worker until released, so tasks queued meanwhile wait together.
+     */
+    struct WorkerGate
+    {
+        explicit WorkerGate(ThreadPool &pool)
+        {
+            pool.Dispatch(TaskPriority::HIGH, [this]
+                          {
+                              started = true;
+                              while (!open.load())
+                                  std::this_thread::yield(); });
+            testing::Eventually([this]
+                                { return started.load(); });
+        }
+
+        void Open() { open = true; }
+
+        std::atomic<bool> started{false};
+        std::atomic<bool> open{false};
+    };
+}
+
+CP_TEST(HigherLanesRunFirst)
+{
+    ThreadPool pool(1);
+    WorkerGate gate(pool);
+
+    std::mutex mutex;
+    std::vector<int> order;
+    for (TaskPriority priority : {TaskPriority::LOW, TaskPriority::NORMAL, TaskPriority::HIGH, TaskPriority::LOW, TaskPriority::HIGH})
+        pool.Dispatch(priority, [&, priority]
+                      {
+                          std::lock_guard<std::mutex> lock(mutex);
+                          order.push_back(static_cast<int>(priority)); });
+    gate.Open();
+
+    CP_CHECK(testing::Eventually([&]
+                                 {
+                                     std::lock_guard<std::mutex> lock(mutex);
+                                     return order.size() == 5; }));
+    CP_CHECK((order == std::vector<int>{0, 0, 1, 2, 2}));
+}
+
+// A LOW task queued behind a stream of HIGH ones gets its turn after kAgingInterval of them.
+CP_TEST(AgingPromotesAStarvedLowTask)
+{
+    constexpr int kHighTasks = 3 * ThreadPool::kAgingInterval;
+
+    ThreadPool pool(1);
+    WorkerGate gate(pool);
+
+    std::mutex mutex;
+    std::vector<int> order;
+    pool.Dispatch(TaskPriority::LOW, [&]
+                  {
+                      std::lock_guard<std::mutex> lock(mutex);
+                      order.push_back(-1); });
+    for (int i = 0; i < kHighTasks; ++i)
+        pool.Dispatch(TaskPriority::HIGH, [&, i]
+                      {
+                          std::lock_guard<std::mutex> lock(mutex);
+                          order.push_back(i); });
+    gate.Open();
+
+    CP_CHECK(testing::Eventually([&]
+                                 {
+                                     std::lock_guard<std::mutex> lock(mutex);
+                                     return order.size() == kHighTasks + 1; }));
+    const auto low = std::find(order.begin(), order.end(), -1);
+    CP_CHECK(low - order.begin() == static_cast<std::ptrdiff_t>(ThreadPool::kAgingInterval));
+}
+
+CP_TEST(StatsAddUpToTheWorkSubmitted)
+{
+    constexpr uint64_t kExternal = 1000;
+    constexpr uint64_t kChildren = 500;
+
+    ThreadPool pool(4);
+    std::atomic<uint64_t> ran{0};
+    for (uint64_t i = 0; i < kExternal; ++i)
+        pool.Dispatch(TaskPriority::NORMAL, [&ran]
+                      { ran.fetch_add(1); });
+    CP_CHECK(testing::Eventually([&]
+                                 { return ran.load() == kExternal; }));
+
+    // The children sit on the root's own deque while it spins without helping, so other workers must steal each one.
+    std::atomic<uint64_t> children{0};
+    std::atomic<bool> rootDone{false};
+    pool.Dispatch(TaskPriority::NORMAL, [&]
+                  {
+                      for (uint64_t i = 0; i < kChildren; ++i)
+                          pool.Dispatch(TaskPriority::NORMAL, [&children]
+                                        { children.fetch_add(1); });
+                      while (children.load() != kChildren)
+                          std::this_thread::yield();
+                      rootDone = true; });
+    CP_CHECK(testing::Eventually([&]
+                                 { return rootDone.load(); }));
+
+    const ThreadPoolStats stats = pool.GetStats();
+    CP_CHECK(stats.total.executed == kExternal + 1 + kChildren);
+    CP_CHECK(stats.total.stolen >= kChildren);
+    CP_CHECK(stats.total.stolen <= stats.total.executed);
+    CP_CHECK(stats.total.queueDepth == 0);
+    CP_CHECK(stats.total.cancelled == 0 && stats.total.expired == 0);
+
+    WorkerStats sum;
+    for (const WorkerStats &worker : stats.workers)
+    {
+        sum.executed += worker.executed;
+        sum.stolen += worker.stolen;
+        CP_CHECK(worker.busyNs + worker.idleNs == stats.uptimeNs);
+    }
+    CP_CHECK(sum.executed == stats.total.executed);
+    CP_CHECK(sum.stolen == stats.total.stolen);
+
+    // Workers with nothing to do (spinning or parked) accrue idle time, not executed tasks.
+    std::this_thread::sleep_for(20ms);
+    const ThreadPoolStats later = pool.GetStats();
+    CP_CHECK(later.total.executed == stats.total.executed);
+    CP_CHECK(later.total.idleNs >= stats.total.idleNs + 4 * std::chrono::nanoseconds(10ms).count());
+    CP_CHECK(later.Utilization() >= 0.0 && later.Utilization() <= 1.0);
+}
+
+CP_TEST(BatchAndRangeSubmission)
+{
+    ThreadPool pool(3);
+    std::atomic<int> ran{0};
+
+    std::vector<Job> jobs;
+    for (int i = 0; i < 1000; ++i)
+        jobs.emplace_back([&ran]
+                          { ran.fetch_add(1); });
+    pool.SubmitBatch(jobs);
+
+    std::vector<std::atomic<int>> hits(500);
+    pool.SubmitRange(0, hits.size(), [&hits, &ran](size_t i)
+                     {
+                         hits[i].fetch_add(1);
+                         ran.fetch_add(1); });
+
+    CP_CHECK(testing::Eventually([&]
+                                 { return ran.load() == 1500; }));
+    for (const std::atomic<int> &hit : hits)
+        CP_CHECK(hit.load() == 1);
+}
+
+#if defined(__linux__)
+namespace
+{
+    /**
+     * @brief NUMA node of @p cpu from sysfs, 0 when the topology is unknown.
+     */
+    uint32_t NodeOf(uint32_t cpu)
+    {
+        std::error_code ec;
+        for (const auto &entry : std::filesystem::directory_iterator("/sys/devices/system/cpu/cpu" + std::to_string(cpu), ec))
+        {
+            const std::string name = entry.path().filename().string();
+            if (name.rfind("node", 0) == 0 && name.size() > 4 && name.find_first_not_of("0123456789", 4) == std::string::npos)
+                return static_cast<uint32_t>(std::stoul(name.substr(4)));
+        }
+        return 0;
+    }
+}
+
+// Each worker reads its own affinity and name from inside a task.
+CP_TEST(WorkersArePinnedAndNamed)
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    CP_CHECK(sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+    std::vector<uint32_t> cpus;
+    for (uint32_t cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        if (CPU_ISSET(cpu, &allowed))
+            cpus.push_back(cpu);
+
+    ThreadPoolConfig config;
+    config.threadCount = std::min<size_t>(cpus.size(), 4);
+    config.affinity = WorkerAffinity::Cpu;
+    config.cpus = cpus;
+    config.threadName = "cp-pin";
+    ThreadPool pool(config);
+
+    // Worker i gets the i-th CPU once they are ordered by node.
+    std::stable_sort(cpus.begin(), cpus.end(), [](uint32_t a, uint32_t b)
+                     { return NodeOf(a) < NodeOf(b); });
+
+    std::mutex mutex;
+    std::vector<std::string> names;
+    std::vector<std::vector<uint32_t>> pinned;
+    std::atomic<size_t> arrived{0};
+    for (size_t i = 0; i < config.threadCount; ++i)
+        pool.Dispatch(TaskPriority::NORMAL, [&]
+                      {
+                          // Hold this worker until every task started, so each one runs on a different worker.
+                          arrived.fetch_add(1);
+                          testing::Eventually([&]
+                                              { return arrived.load() == config.threadCount; });
+
+                          cpu_set_t set;
+                          CPU_ZERO(&set);
+                          sched_getaffinity(0, sizeof(set), &set);
+                          std::vector<uint32_t> mine;
+                          for (uint32_t cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                              if (CPU_ISSET(cpu, &set))
+                                  mine.push_back(cpu);
+                          char name[16] = {};
+                          pthread_getname_np(pthread_self(), name, sizeof(name));
+
+                          std::lock_guard<std::mutex> lock(mutex);
+                          names.emplace_back(name);
+                          pinned.push_back(std::move(mine)); });
+
+    CP_CHECK(testing::Eventually([&]
+                                 {
+                                     std::lock_guard<std::mutex> lock(mutex);
+                                     return names.size() == config.threadCount; }));
+
+    bool matched = true;
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        const std::string prefix = "cp-pin-";
+        const bool named = names[i].rfind(prefix, 0) == 0 && names[i].size() > prefix.size();
+        CP_CHECK(named);
+        if (!named)
+            continue;
+        const size_t worker = std::stoul(names[i].substr(prefix.size()));
+        matched &= worker < config.threadCount && pinned[i] == std::vector<uint32_t>{cpus[worker]};
+    }
+    CP_CHECK(matched);
+}
+#endif
+
+CP_TEST(CancelledAndExpiredTasksAreDropped)
+{
+    ThreadPool pool(1);
+    std::promise<void> gate;
+    std::shared_future<void> open = gate.get_future().share();
+    // Keep the only worker busy so the tasks below are still queued when dropped.
+    pool.Dispatch(TaskPriority::HIGH, [open]
+                  { open.wait(); });
+
+    CancellationSource source;
+    TaskOptions cancelled;
+    cancelled.token = source.Token();
+    TaskOptions expired;
+    expired.deadline = TaskOptions::Clock::now() + 1ms;
+
+    std::atomic<int> ran{0};
+    auto dropped = pool.Submit(cancelled, [&ran]
+                               { ran.fetch_add(1); });
+    pool.Dispatch(expired, [&ran]
+                  { ran.fetch_add(1); });
+    auto kept = pool.Submit(TaskOptions{}, [&ran]
+                            { ran.fetch_add(1); });
+
+    source.Cancel();
+    std::this_thread::sleep_for(5ms);
+    gate.set_value();
+
+    kept.get();
+    CP_CHECK_THROWS(dropped.get(), std::future_error);
+    CP_CHECK(testing::Eventually([&]
+                                 {
+                                     const ThreadPoolStats stats = pool.GetStats();
+                                     return stats.total.cancelled == 1 && stats.total.expired == 1; }));
+    CP_CHECK(ran.load() == 1);
+    // The gate and the kept task; drops are not counted as executed.
+    CP_CHECK(pool.GetStats().total.executed == 2);
+}
+
+// A thread outside the pool only helps with the priorities it waits for.
+CP_TEST(HelpingIsLimitedToTheWaitedPriority)
+{
+    ThreadPool pool(1);
+    std::atomic<bool> started{false};
+    std::atomic<bool> gate{false};
+    std::atomic<bool> low{false};
+    std::atomic<bool> normal{false};
+    // Keeps the only worker busy so the waiting thread is the only one that can run anything.
+    pool.Dispatch(TaskPriority::HIGH, [&]
+                  {
+                      started = true;
+                      while (!gate.load())
+                          std::this_thread::yield(); });
+    CP_CHECK(testing::Eventually([&started]
+                                 { return started.load(); }));
+
+    pool.Dispatch(TaskPriority::LOW, [&low]
+                  { low = true; });
+    pool.Dispatch(TaskPriority::NORMAL, [&normal]
+                  { normal = true; });
+    pool.WaitUntil([&normal]
+                   { return normal.load(); },
+                   TaskPriority::NORMAL);
+    CP_CHECK(!low.load());
+
+    gate = true;
+    pool.WaitUntil([&low]
+                   { return low.load(); });
+}
+
+CP_TEST(DelayedAndPeriodicTasks)
+{
+    ThreadPool pool(2);
+    const auto start = std::chrono::steady_clock::now();
+    auto delayed = pool.SubmitAfter(20ms, [start]
+                                    { return std::chrono::steady_clock::now() - start; });
+
+    CancellationSource stop;
+    std::atomic<int> ticks{0};
+    pool.SubmitEvery(2ms, [&ticks]
+                     { ticks.fetch_add(1); },
+                     stop.Token());
+
+    CP_CHECK(delayed.get() >= 20ms);
+    CP_CHECK(testing::Eventually([&]
+                                 { return ticks.load() >= 3; }));
+    stop.Cancel();
+}
+
+CP_TEST(ShutdownDrainsAndRejects)
+{
+    ThreadPool pool(2);
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 1000; ++i)
+        pool.Dispatch(TaskPriority::NORMAL, [&ran]
+                      { ran.fetch_add(1); });
+    pool.Shutdown();
+
+    CP_CHECK(ran.load() == 1000);
+    CP_CHECK_THROWS(pool.Dispatch(TaskPriority::NORMAL, [] {}), std::runtime_error);
+    CP_CHECK_THROWS(pool.Submit(TaskPriority::NORMAL, [] {}), std::runtime_error);
+}
+
+CP_TEST(ElasticPoolGrowsUnderLoadAndRetiresWhenIdle)
+{
+    std::mutex mutex;
+    std::vector<std::pair<size_t, size_t>> resizes;
+    ThreadPoolConfig config;
+    config.threadCount = 4;
+    config.minThreadCount = 1;
+    config.growQueueDepth = 2;
+    config.idleRetireTime = 50ms;
+    config.onResize = [&](size_t from, size_t to)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        resizes.emplace_back(from, to);
+    };
+    ThreadPool pool(config);
+    CP_CHECK(pool.GetThreadCount() == 1);
+    CP_CHECK(pool.GetMaxThreadCount() == 4);
+
+    // Blocked tasks keep every running worker busy, so queues only deepen and the pool grows.
+    std::atomic<bool> release{false};
+    std::atomic<int> submitted{0};
+    std::atomic<int> ran{0};
+    CP_CHECK(testing::Eventually([&]
+                                 {
+                                     for (int i = 0; i < 4; ++i, ++submitted)
+                                         pool.Dispatch(TaskPriority::NORMAL, [&]
+                                                       {
+                                                           while (!release.load())
+                                                               std::this_thread::yield();
+                                                           ran.fetch_add(1); });
+                                     std::this_thread::sleep_for(1ms);
+                                     return pool.GetThreadCount() == 4; }));
+
+    release = true;
+    CP_CHECK(testing::Eventually([&]
+                                 { return ran.load() == submitted.load(); }));
+
+    // Idle for longer than idleRetireTime: back down to the minimum, never below.
+    CP_CHECK(testing::Eventually([&]
+                                 { return pool.GetThreadCount() == 1; }));
+    std::this_thread::sleep_for(150ms);
+    CP_CHECK(pool.GetThreadCount() == 1);
+
+    const ThreadPoolStats stats = pool.GetStats();
+    CP_CHECK(stats.spawned == 3);
+    CP_CHECK(stats.retired == 3);
+    CP_CHECK(stats.activeWorkers == 1);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t grown = 0, shrunk = 0;
+        for (const auto &[from, to] : resizes)
+        {
+            grown += to == from + 1;
+            shrunk += to + 1 == from;
+        }
+        CP_CHECK(grown == 3 && shrunk == 3 && resizes.size() == 6);
+    }
+
+    // The remaining worker still serves tasks.
+    CP_CHECK(pool.Submit(TaskPriority::NORMAL, []
+                         { return 7; })
+                 .get() == 7);
+}
+
+// Workers that fall behind try to grow the pool while Shutdown() is collecting them.
+CP_TEST(ElasticShutdownWhileGrowing)
+{
+    for (int round = 0; round < 20; ++round)
+    {
+        ThreadPoolConfig config;
+        config.threadCount = 8;
+        config.minThreadCount = 1;
+        config.growLatency = std::chrono::microseconds(1);
+        ThreadPool pool(config);
+
+        std::atomic<int> ran{0};
+        for (int i = 0; i < 2000; ++i)
+            pool.Dispatch(TaskPriority::NORMAL, [&ran]
+                          {
+                              volatile int spin = 0;
+                              while (spin < 2000)
+                                  spin = spin + 1;
+                              ran.fetch_add(1); });
+        // Right away: the pool is still growing (one worker per cooldown) with most jobs queued.
+        pool.Shutdown();
+        CP_CHECK(ran.load() == 2000);
+    }
+}
+
+CP_TEST(DeterministicReplayRepeatsPlacement)
+{
+    auto run = [](const ThreadPoolConfig &config)
+    {
+        ThreadPool pool(config);
+        std::atomic<int> ran{0};
+        for (int i = 0; i < 200; ++i)
+            pool.Dispatch(TaskPriority::NORMAL, [&pool, &ran]
+                          {
+                              for (int j = 0; j < 4; ++j)
+                                  pool.Dispatch(TaskPriority::NORMAL, [&ran]
+                                                { ran.fetch_add(1); }); });
+        testing::Eventually([&]
+                            { return ran.load() == 800; });
+        pool.Shutdown();
+        return pool.GetScheduleLog();
+    };
+
+    ThreadPoolConfig config;
+    config.threadCount = 3;
+    config.deterministic = true;
+    config.seed = 42;
+    const ScheduleLog recorded = run(config);
+    CP_CHECK(recorded.records.size() == 1000);
+
+    config.replay = std::make_shared<ScheduleLog>(recorded);
+    const ScheduleLog replayed = run(config);
+    CP_CHECK(replayed.records.size() == recorded.records.size());
+
+    size_t moved = 0;
+    for (size_t i = 0; i < replayed.records.size(); ++i)
+        moved += replayed.records[i].task != recorded.records[i].task ||
+                 replayed.records[i].worker != recorded.records[i].worker;
+    CP_CHECK(moved == 0);
+}
+
+int main()
+{
+    return cp::testing::RunAll();
+}
@@ -0,0 +1,118 @@
+#include "testing.hpp"
+#include <cp_framework/threading/timerWheel.hpp>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace
+{
+    struct Timer
+    {
+        uint64_t deadline = 0;
+        Timer *next = nullptr;
+        uint64_t due = 0;   ///< Requested deadline, kept since the wheel rewrites `deadline`
+        uint64_t fired = 0; ///< Tick at which the timer expired, 0 = not yet
+    };
+
+    using Wheel = cp::TimerWheel<Timer>;
+}
+
+CP_TEST(TimersFireAtTheirTick)
+{
+    Wheel wheel;
+    std::vector<Timer> timers(3);
+    timers[0].deadline = 5;
+    timers[1].deadline = 1;
+    timers[2].deadline = 64;
+    for (Timer &timer : timers)
+    {
+        timer.due = timer.deadline;
+        wheel.Insert(&timer);
+    }
+    CP_CHECK(wheel.Size() == 3);
+    CP_CHECK(wheel.NextEventTick() == 1);
+
+    for (uint64_t tick = 1; tick <= 64; ++tick)
+        wheel.Advance(tick, [tick](Timer *timer)
+                      { timer->fired = tick; });
+
+    for (const Timer &timer : timers)
+        CP_CHECK(timer.fired == timer.due);
+    CP_CHECK(wheel.Empty());
+    CP_CHECK(wheel.NextEventTick() == Wheel::kNever);
+}
+
+// Deadlines spread over every level cascade down and expire exactly on time, even when the clock jumps.
+CP_TEST(CascadeAcrossLevels)
+{
+    std::mt19937_64 rng(7);
+    std::vector<Timer> timers(5000);
+    Wheel wheel;
+    for (Timer &timer : timers)
+    {
+        const uint64_t level = rng() % 4;
+        timer.deadline = 1 + rng() % (uint64_t(64) << (6 * level));
+        timer.due = timer.deadline;
+        wheel.Insert(&timer);
+    }
+
+    size_t fired = 0;
+    while (!wheel.Empty())
+    {
+        // Land on the next event exactly, or overshoot it by a few ticks.
+        const uint64_t now = wheel.NextEventTick() + rng() % 3;
+        wheel.Advance(now, [&](Timer *timer)
+                      {
+                          timer->fired = now;
+                          ++fired; });
+    }
+
+    CP_CHECK(fired == timers.size());
+    size_t wrong = 0;
+    for (const Timer &timer : timers)
+        wrong += timer.fired < timer.due || timer.fired > timer.due + 2;
+    CP_CHECK(wrong == 0);
+}
+
+CP_TEST(FarDeadlinesAreRefiled)
+{
+    Wheel wheel;
+    Timer timer;
+    timer.deadline = (uint64_t(1) << 24) + 100;
+    timer.due = timer.deadline;
+    wheel.Insert(&timer);
+
+    while (!wheel.Empty())
+        wheel.Advance(wheel.NextEventTick(), [](Timer *t)
+                      { t->fired = t->deadline; });
+    CP_CHECK(timer.fired == timer.due);
+}
+
+CP_TEST(ReinsertFromCallbackAndClear)
+{
+    Wheel wheel;
+    Timer periodic;
+    periodic.deadline = 10;
+    wheel.Insert(&periodic);
+
+    int runs = 0;
+    for (uint64_t tick = 1; tick <= 100; ++tick)
+        wheel.Advance(tick, [&](Timer *timer)
+                      {
+                          ++runs;
+                          timer->deadline += 10;
+                          wheel.Insert(timer); });
+    CP_CHECK(runs == 10);
+    CP_CHECK(wheel.Size() == 1);
+
+    int removed = 0;
+    wheel.Clear([&](Timer *)
+                { ++removed; });
+    CP_CHECK(removed == 1);
+    CP_CHECK(wheel.Empty());
+}
+
+int main()
+{
+    return cp::testing::RunAll();
+}
@@ -0,0 +1,88 @@
+#include "testing.hpp"
+#include <cp_framework/threading/workStealingDeque.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using cp::WorkStealingDeque;
+
+CP_TEST(PopIsLifoStealIsFifo)
+{
+    WorkStealingDeque<int> deque(2);
+    for (int i = 1; i <= 5; ++i)
+        deque.Push(i);
+    CP_CHECK(deque.Size() == 5);
+
+    CP_CHECK(deque.Steal() == 1);
+    CP_CHECK(deque.Pop() == 5);
+    CP_CHECK(deque.Steal() == 2);
+    CP_CHECK(deque.Pop() == 4);
+    CP_CHECK(deque.Pop() == 3);
+    CP_CHECK(!deque.Pop());
+    CP_CHECK(!deque.Steal());
+    CP_CHECK(deque.Empty());
+}
+
+CP_TEST(GrowKeepsQueuedItems)
+{
+    WorkStealingDeque<int> deque(4);
+    for (int i = 0; i < 3; ++i)
+        deque.Push(i);
+    CP_CHECK(deque.Steal() == 0);
+
+    // Wraps around the initial ring, then forces two resizes.
+    for (int i = 3; i < 20; ++i)
+        deque.Push(i);
+    for (int i = 1; i < 20; ++i)
+        CP_CHECK(deque.Steal() == i);
+    CP_CHECK(deque.Empty());
+}
+
+// The owner pushes and pops while thieves steal: every item must be taken exactly once.
+CP_TEST(ConcurrentPopAndStealTakeEveryItemOnce)
+{
+    constexpr int kItems = 200000;
+    constexpr int kThieves = 3;
+
+    WorkStealingDeque<int> deque(16);
+    std::vector<std::atomic<int>> taken(kItems);
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < kThieves; ++t)
+        thieves.emplace_back([&]
+                             {
+                                 while (!done.load(std::memory_order_acquire))
+                                 {
+                                     if (auto item = deque.Steal())
+                                         taken[*item].fetch_add(1, std::memory_order_relaxed);
+                                     else
+                                         std::this_thread::yield();
+                                 } });
+
+    for (int i = 0; i < kItems; ++i)
+    {
+        deque.Push(i);
+        // Pop every other push so the owner keeps racing thieves for the last item.
+        if (i % 2 == 1)
+            if (auto item = deque.Pop())
+                taken[*item].fetch_add(1, std::memory_order_relaxed);
+    }
+    while (auto item = deque.Pop())
+        taken[*item].fetch_add(1, std::memory_order_relaxed);
+
+    // Whatever a thief claimed before the deque drained has been counted once it stops.
+    done.store(true, std::memory_order_release);
+    for (std::thread &thief : thieves)
+        thief.join();
+
+    int wrong = 0;
+    for (const std::atomic<int> &count : taken)
+        wrong += count.load() != 1;
+    CP_CHECK(wrong == 0);
+}
+
+int main()
+{
+    return cp::testing::RunAll();
+}
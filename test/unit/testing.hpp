@@ -0,0 +1,128 @@
+/**
+ * @file testing.hpp
+ * @brief Minimal test registry and check macros shared by the unit tests.
+ *
+ * Every test file is its own executable registered with CTest. Test cases
+ * declared with CP_TEST run in declaration order; a failed CP_CHECK reports
+ * the expression and keeps going, and the process exits non-zero if any
+ * check failed.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace cp::testing
+{
+    /**
+     * @brief A registered test case.
+     */
+    struct TestCase
+    {
+        const char *name; ///< Function name, for the report
+        void (*run)();    ///< Test body
+    };
+
+    inline std::vector<TestCase> &Registry()
+    {
+        static std::vector<TestCase> tests;
+        return tests;
+    }
+
+    inline int &FailureCount()
+    {
+        static int failures = 0;
+        return failures;
+    }
+
+    /**
+     * @brief Adds a test case to the registry at static initialization.
+     */
+    struct Registrar
+    {
+        Registrar(const char *name, void (*run)()) { Registry().push_back({name, run}); }
+    };
+
+    inline void Fail(const char *file, int line, const char *expression)
+    {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+        ++FailureCount();
+    }
+
+    /**
+     * @brief Polls @p done until it returns true or @p timeout elapses.
+     *
+     * @return Whether @p done became true; lets a hang fail a check instead of the whole run.
+     */
+    template <typename Predicate>
+    bool Eventually(Predicate &&done, std::chrono::milliseconds timeout = std::chrono::seconds(10))
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!done())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Runs every registered test case and reports the outcome.
+     *
+     * @return Process exit code: 0 if every check passed.
+     */
+    inline int RunAll()
+    {
+        for (const TestCase &test : Registry())
+        {
+            const int before = FailureCount();
+            try
+            {
+                test.run();
+            }
+            catch (const std::exception &e)
+            {
+                std::fprintf(stderr, "%s: unexpected exception: %s\n", test.name, e.what());
+                ++FailureCount();
+            }
+            std::printf("[%s] %s\n", FailureCount() == before ? "  OK  " : " FAIL ", test.name);
+        }
+        return FailureCount() == 0 ? 0 : 1;
+    }
+} // namespace cp::testing
+
+/// @brief Declares and registers a test case.
+#define CP_TEST(name)                                                                   \
+    static void name();                                                                 \
+    static const ::cp::testing::Registrar name##Registrar(#name, &name);                \
+    static void name()
+
+/// @brief Records a failure if @p expression is false.
+#define CP_CHECK(expression)                                                            \
+    do                                                                                  \
+    {                                                                                   \
+        if (!(expression))                                                              \
+            ::cp::testing::Fail(__FILE__, __LINE__, #expression);                       \
+    } while (0)
+
+/// @brief Records a failure unless @p expression throws @p exception.
+#define CP_CHECK_THROWS(expression, exception)                                          \
+    do                                                                                  \
+    {                                                                                   \
+        bool thrown = false;                                                            \
+        try                                                                             \
+        {                                                                               \
+            (void)(expression);                                                         \
+        }                                                                               \
+        catch (const exception &)                                                       \
+        {                                                                               \
+            thrown = true;                                                              \
+        }                                                                               \
+        if (!thrown)                                                                    \
+            ::cp::testing::Fail(__FILE__, __LINE__, #expression " throws " #exception); \
+    } while (0)